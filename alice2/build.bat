@@ -32,6 +32,13 @@ echo [alice2] Building...
 cmake --build "%BUILD_DIR%" --config %CONFIG% -- /m
 if errorlevel 1 goto :fail
 
+if /I "%~1"=="test" (
+    echo.
+    echo [alice2] Running unit tests...
+    ctest --test-dir "%BUILD_DIR%" -C %CONFIG% --output-on-failure
+    if errorlevel 1 goto :fail
+)
+
 echo.
 echo [alice2] Build finished successfully.
 goto :eof
@@ -0,0 +1,319 @@
+#include "CompactScalarField3D.h"
+#include "SdfExpression.h"
+#include "../objects/MeshObject.h"
+#include "../utils/Parallel.h"
+#include "../utils/Simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace alice2 {
+
+    namespace {
+        constexpr float HALF_MAX = 65504.0f;       // largest finite fp16; larger values are clamped, not inf
+        constexpr int ENCODE_BLOCK = 256;           // points converted per stack buffer
+    }
+
+    // Constructor
+    CompactScalarField3D::CompactScalarField3D(const Vec3& min_bb, const Vec3& max_bb, int res_x, int res_y, int res_z,
+                                               FieldStorage storage, float band_width)
+        : m_min_bounds(min_bb), m_max_bounds(max_bb), m_res_x(res_x), m_res_y(res_y), m_res_z(res_z),
+          m_storage(storage) {
+        if (res_x <= 0 || res_y <= 0 || res_z <= 0) {
+            throw std::invalid_argument("Resolution must be positive");
+        }
+
+        m_grid_step = get_cell_size();
+        const float max_step = std::max({m_grid_step.x, m_grid_step.y, m_grid_step.z});
+        m_band_width = band_width > 0.0f ? band_width : 3.0f * max_step;
+
+        const size_t total_points = static_cast<size_t>(res_x) * res_y * res_z;
+        const float levels = storage == FieldStorage::Quantized8 ? 255.0f : 65535.0f;
+        m_quant_scale = 2.0f * m_band_width / levels;
+        m_quant_offset = -m_band_width;
+        if (storage == FieldStorage::Quantized8) {
+            m_codes8.resize(total_points);
+        } else {
+            m_codes16.resize(total_points);
+        }
+        clear_field(0.0f);
+    }
+
+    CompactScalarField3D::CompactScalarField3D(const ScalarField3D& field, FieldStorage storage, float band_width)
+        : CompactScalarField3D(field.get_bounds().first, field.get_bounds().second,
+                               std::get<0>(field.get_resolution()), std::get<1>(field.get_resolution()),
+                               std::get<2>(field.get_resolution()), storage, band_width) {
+        m_extract_settings = field.get_extract_settings();
+        set_values(field.get_values());
+    }
+
+    Vec3 CompactScalarField3D::get_cell_size() const {
+        return Vec3(
+            (m_max_bounds.x - m_min_bounds.x) / std::max(1, m_res_x - 1),
+            (m_max_bounds.y - m_min_bounds.y) / std::max(1, m_res_y - 1),
+            (m_max_bounds.z - m_min_bounds.z) / std::max(1, m_res_z - 1)
+        );
+    }
+
+    Vec3 CompactScalarField3D::cell_position(int x, int y, int z) const {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        return grid_point(x, y, z);
+    }
+
+    // Encoding clamps to the representable range; quantized codes round to the nearest level
+    void CompactScalarField3D::encode(size_t begin, int count, const float* values) {
+        if (m_storage == FieldStorage::Half) {
+            float clamped[ENCODE_BLOCK];
+            for (int done = 0; done < count; done += ENCODE_BLOCK) {
+                const int n = std::min(ENCODE_BLOCK, count - done);
+                for (int i = 0; i < n; ++i) {
+                    clamped[i] = std::clamp(values[done + i], -HALF_MAX, HALF_MAX);
+                }
+                simd::encode_half(clamped, &m_codes16[begin + done], n);
+            }
+            return;
+        }
+
+        const float inv_scale = 1.0f / m_quant_scale;
+        const float max_code = m_storage == FieldStorage::Quantized8 ? 255.0f : 65535.0f;
+        for (int i = 0; i < count; ++i) {
+            const float code = std::clamp((values[i] - m_quant_offset) * inv_scale + 0.5f, 0.0f, max_code);
+            if (m_storage == FieldStorage::Quantized8) {
+                m_codes8[begin + i] = static_cast<uint8_t>(code);
+            } else {
+                m_codes16[begin + i] = static_cast<uint16_t>(code);
+            }
+        }
+    }
+
+    void CompactScalarField3D::decode(size_t begin, int count, float* values) const {
+        switch (m_storage) {
+            case FieldStorage::Half:
+                simd::decode_half(&m_codes16[begin], values, count);
+                break;
+            case FieldStorage::Quantized16:
+                simd::decode_quantized(&m_codes16[begin], values, count, m_quant_scale, m_quant_offset);
+                break;
+            case FieldStorage::Quantized8:
+                simd::decode_quantized(&m_codes8[begin], values, count, m_quant_scale, m_quant_offset);
+                break;
+        }
+    }
+
+    float CompactScalarField3D::get_value(int x, int y, int z) const {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        float value;
+        decode(get_index(x, y, z), 1, &value);
+        return value;
+    }
+
+    void CompactScalarField3D::set_value(int x, int y, int z, float value) {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        encode(get_index(x, y, z), 1, &value);
+    }
+
+    std::vector<float> CompactScalarField3D::get_values() const {
+        std::vector<float> values(static_cast<size_t>(m_res_x) * m_res_y * m_res_z);
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            const size_t begin = get_index(0, 0, k);
+            decode(begin, m_res_x * m_res_y, &values[begin]);
+        });
+        return values;
+    }
+
+    void CompactScalarField3D::set_values(const std::vector<float>& values) {
+        if (values.size() != static_cast<size_t>(m_res_x) * m_res_y * m_res_z) {
+            throw std::invalid_argument("Values size must match grid size");
+        }
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            const size_t begin = get_index(0, 0, k);
+            encode(begin, m_res_x * m_res_y, &values[begin]);
+        });
+    }
+
+    ScalarField3D CompactScalarField3D::to_field() const {
+        ScalarField3D field(m_min_bounds, m_max_bounds, m_res_x, m_res_y, m_res_z);
+        field.set_extract_settings(m_extract_settings);
+        field.set_values(get_values());
+        return field;
+    }
+
+    float CompactScalarField3D::sample_trilinear(const Vec3& p) const {
+        // Convert world position to grid coordinates
+        const float fx = (p.x - m_min_bounds.x) / (m_max_bounds.x - m_min_bounds.x) * (m_res_x - 1);
+        const float fy = (p.y - m_min_bounds.y) / (m_max_bounds.y - m_min_bounds.y) * (m_res_y - 1);
+        const float fz = (p.z - m_min_bounds.z) / (m_max_bounds.z - m_min_bounds.z) * (m_res_z - 1);
+
+        const int x0 = std::clamp(static_cast<int>(std::floor(fx)), 0, std::max(0, m_res_x - 2));
+        const int y0 = std::clamp(static_cast<int>(std::floor(fy)), 0, std::max(0, m_res_y - 2));
+        const int z0 = std::clamp(static_cast<int>(std::floor(fz)), 0, std::max(0, m_res_z - 2));
+        const int dx = m_res_x > 1 ? 2 : 1;
+        const int y1 = std::min(y0 + 1, m_res_y - 1);
+        const int z1 = std::min(z0 + 1, m_res_z - 1);
+
+        // Decode the two x-neighbours of each of the four rows around p
+        float c[4][2];
+        const int rows[4][2] = {{y0, z0}, {y1, z0}, {y0, z1}, {y1, z1}};
+        for (int r = 0; r < 4; ++r) {
+            decode(get_index(x0, rows[r][0], rows[r][1]), dx, c[r]);
+            if (dx == 1) c[r][1] = c[r][0];
+        }
+
+        const float tx = fx - x0;
+        const float ty = fy - y0;
+        const float tz = fz - z0;
+        const float c00 = c[0][0] * (1 - tx) + c[0][1] * tx;
+        const float c10 = c[1][0] * (1 - tx) + c[1][1] * tx;
+        const float c01 = c[2][0] * (1 - tx) + c[2][1] * tx;
+        const float c11 = c[3][0] * (1 - tx) + c[3][1] * tx;
+        const float c0 = c00 * (1 - ty) + c10 * ty;
+        const float c1 = c01 * (1 - ty) + c11 * ty;
+        return c0 * (1 - tz) + c1 * tz;
+    }
+
+    // Central differences over half a cell, as ScalarField3D::gradient_at
+    Vec3 CompactScalarField3D::gradient_at(const Vec3& p) const {
+        float eps = 0.5f * std::min({m_grid_step.x, m_grid_step.y, m_grid_step.z});
+        if (eps <= 0.0f) eps = 1.0f;   // flat grid axis
+
+        const float dx = sample_trilinear(Vec3(p.x + eps, p.y, p.z)) - sample_trilinear(Vec3(p.x - eps, p.y, p.z));
+        const float dy = sample_trilinear(Vec3(p.x, p.y + eps, p.z)) - sample_trilinear(Vec3(p.x, p.y - eps, p.z));
+        const float dz = sample_trilinear(Vec3(p.x, p.y, p.z + eps)) - sample_trilinear(Vec3(p.x, p.y, p.z - eps));
+        return Vec3(dx, dy, dz) * (0.5f / eps);
+    }
+
+    void CompactScalarField3D::clear_field(float value) {
+        const std::vector<float> row(m_res_x, value);
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            for (int j = 0; j < m_res_y; ++j) {
+                encode(get_index(0, j, k), m_res_x, row.data());
+            }
+        });
+    }
+
+    // Rows are evaluated into a float buffer and encoded; nothing grid-sized is allocated
+    void CompactScalarField3D::apply_sdf(const SdfExpression& expression) {
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            std::vector<float> xs(m_res_x), ys(m_res_x), zs(m_res_x), out(m_res_x), scratch;
+            for (int j = 0; j < m_res_y; ++j) {
+                for (int i = 0; i < m_res_x; ++i) {
+                    const Vec3 pt = grid_point(i, j, k);
+                    xs[i] = pt.x;
+                    ys[i] = pt.y;
+                    zs[i] = pt.z;
+                }
+                expression.evaluate(xs.data(), ys.data(), zs.data(), m_res_x, out.data(), scratch);
+                encode(get_index(0, j, k), m_res_x, out.data());
+            }
+        });
+    }
+
+    // Polygonize cell layers [z_begin, z_end). Each layer needs its two bounding z-slices decoded;
+    // the upper slice of one layer is reused as the lower slice of the next.
+    void CompactScalarField3D::extract_slab(float isolevel, int z_begin, int z_end, std::vector<MCTriangle>& triangles) const {
+        const size_t slice_size = static_cast<size_t>(m_res_x) * m_res_y;
+        std::vector<float> lower(slice_size), upper(slice_size);
+        decode(get_index(0, 0, z_begin), static_cast<int>(slice_size), lower.data());
+
+        static const int corner_offsets[8][3] = {
+            {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+            {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+        };
+
+        for (int k = z_begin; k < z_end; ++k) {
+            decode(get_index(0, 0, k + 1), static_cast<int>(slice_size), upper.data());
+            const float* slices[2] = {lower.data(), upper.data()};
+            for (int j = 0; j < m_res_y - 1; ++j) {
+                for (int i = 0; i < m_res_x - 1; ++i) {
+                    float values[8];
+                    int negative = 0;
+                    for (int c = 0; c < 8; ++c) {
+                        const int x = i + corner_offsets[c][0];
+                        const int y = j + corner_offsets[c][1];
+                        values[c] = slices[corner_offsets[c][2]][static_cast<size_t>(y) * m_res_x + x];
+                        negative += ScalarField3D::classify_vertex(values[c], isolevel) == alice2::VertexClass::NEGATIVE;
+                    }
+                    if (negative == 0 || negative == 8) continue;
+
+                    GridCell cell;
+                    for (int c = 0; c < 8; ++c) {
+                        cell.vertices[c] = grid_point(i + corner_offsets[c][0], j + corner_offsets[c][1], k + corner_offsets[c][2]);
+                        cell.values[c] = values[c];
+                        cell.classes[c] = ScalarField3D::classify_vertex(values[c], isolevel);
+                    }
+                    ScalarField3D::polygonize_cell(cell, isolevel, triangles);
+                }
+            }
+            std::swap(lower, upper);
+        }
+    }
+
+    // Cell layers are split into contiguous slabs that are polygonized in parallel and
+    // concatenated in order
+    std::vector<MCTriangle> CompactScalarField3D::extract_triangles(float isolevel) const {
+        std::vector<MCTriangle> triangles;
+        if (m_res_x < 2 || m_res_y < 2 || m_res_z < 2) {
+            return triangles;
+        }
+
+        const int layers = m_res_z - 1;
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        const int slab_count = std::max(1, std::min(layers, num_threads == 1 ? 1 : num_threads * 4));
+        const int slab_size = (layers + slab_count - 1) / slab_count;
+
+        std::vector<std::vector<MCTriangle>> slab_triangles(slab_count);
+        parallel_for(slab_count, num_threads, [&](int slab) {
+            const int z_begin = slab * slab_size;
+            const int z_end = std::min(layers, z_begin + slab_size);
+            if (z_begin < z_end) {
+                extract_slab(isolevel, z_begin, z_end, slab_triangles[slab]);
+            }
+        });
+
+        size_t total = 0;
+        for (const auto& slab : slab_triangles) {
+            total += slab.size();
+        }
+        triangles.reserve(total);
+        for (const auto& slab : slab_triangles) {
+            triangles.insert(triangles.end(), slab.begin(), slab.end());
+        }
+
+        return triangles;
+    }
+
+    // Generate mesh data from the compact field
+    std::shared_ptr<MeshData> CompactScalarField3D::generate_mesh(float isolevel) const {
+        auto meshData = std::make_shared<MeshData>();
+        std::vector<MCTriangle> triangles = extract_triangles(isolevel);
+
+        meshData->vertices.reserve(triangles.size() * 3);
+        meshData->faces.reserve(triangles.size());
+        for (const auto& triangle : triangles) {
+            int baseIndex = static_cast<int>(meshData->vertices.size());
+
+            for (int i = 0; i < 3; ++i) {
+                MeshVertex vertex;
+                vertex.position = triangle.vertices[i];
+                vertex.normal = triangle.normal;
+                vertex.color = Color(0.8f, 0.8f, 0.9f);
+                meshData->vertices.push_back(vertex);
+            }
+
+            MeshFace face;
+            face.vertices = {baseIndex, baseIndex + 1, baseIndex + 2};
+            face.normal = triangle.normal;
+            face.color = Color(0.8f, 0.8f, 0.9f);
+            meshData->faces.push_back(face);
+        }
+
+        meshData->triangulationDirty = true;
+        return meshData;
+    }
+
+} // namespace alice2
@@ -0,0 +1,123 @@
+#pragma once
+
+#ifndef ALICE2_COMPACT_SCALAR_FIELD_3D_H
+#define ALICE2_COMPACT_SCALAR_FIELD_3D_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "ScalarField3D.h"
+
+namespace alice2 {
+
+    class SdfExpression;
+
+    // Value encodings of CompactScalarField3D
+    enum class FieldStorage {
+        Half,           // IEEE fp16: ~3 significant digits everywhere, magnitudes up to 65504
+        Quantized16,    // 16-bit codes spread evenly over [-band_width, band_width]
+        Quantized8      // 8-bit codes over the same range
+    };
+
+    /**
+     * Dense 3D scalar field stored at 1 or 2 bytes per grid point.
+     * Values are encoded on write and decoded a row at a time with SIMD on read, so sampling and
+     * marching cubes work on floats while the grid itself costs 2-4x less than ScalarField3D.
+     * Quantized storage clamps values to the narrow band [-band_width, band_width]; isolevels must
+     * lie inside it. The API mirrors the ScalarField3D calls needed to build and mesh a field.
+     */
+    class CompactScalarField3D {
+    private:
+        // Grid properties
+        Vec3 m_min_bounds;
+        Vec3 m_max_bounds;
+        int m_res_x;
+        int m_res_y;
+        int m_res_z;
+        Vec3 m_grid_step;
+
+        // Encoded values: m_codes16 for Half and Quantized16, m_codes8 for Quantized8
+        FieldStorage m_storage;
+        float m_band_width;
+        float m_quant_scale;     // decoded value = code * scale + offset
+        float m_quant_offset;
+        std::vector<uint16_t> m_codes16;
+        std::vector<uint8_t> m_codes8;
+
+        // Extraction options
+        MCExtractSettings m_extract_settings;
+
+        // Helper methods
+        inline size_t get_index(int x, int y, int z) const {
+            return (static_cast<size_t>(z) * m_res_y + y) * m_res_x + x;
+        }
+
+        inline Vec3 grid_point(int x, int y, int z) const {
+            return Vec3(m_min_bounds.x + x * m_grid_step.x,
+                        m_min_bounds.y + y * m_grid_step.y,
+                        m_min_bounds.z + z * m_grid_step.z);
+        }
+
+        inline bool is_valid_coords(int x, int y, int z) const {
+            return x >= 0 && x < m_res_x && y >= 0 && y < m_res_y && z >= 0 && z < m_res_z;
+        }
+
+        void extract_slab(float isolevel, int z_begin, int z_end, std::vector<MCTriangle>& triangles) const;
+
+    public:
+        // band_width <= 0 selects three cells of the coarsest axis spacing (used by quantized storage)
+        CompactScalarField3D(const Vec3& min_bb = Vec3(-50, -50, -50),
+                             const Vec3& max_bb = Vec3(50, 50, 50),
+                             int res_x = 50,
+                             int res_y = 50,
+                             int res_z = 50,
+                             FieldStorage storage = FieldStorage::Half,
+                             float band_width = 0.0f);
+        // Encode an existing field with its bounds and resolution
+        explicit CompactScalarField3D(const ScalarField3D& field,
+                                      FieldStorage storage = FieldStorage::Half,
+                                      float band_width = 0.0f);
+
+        ~CompactScalarField3D() = default;
+        CompactScalarField3D(const CompactScalarField3D& other) = default;
+        CompactScalarField3D& operator=(const CompactScalarField3D& other) = default;
+        CompactScalarField3D(CompactScalarField3D&& other) noexcept = default;
+        CompactScalarField3D& operator=(CompactScalarField3D&& other) noexcept = default;
+
+        // Getter/Setter methods
+        std::tuple<int, int, int> get_resolution() const { return {m_res_x, m_res_y, m_res_z}; }
+        std::pair<Vec3, Vec3> get_bounds() const { return {m_min_bounds, m_max_bounds}; }
+        FieldStorage get_storage() const { return m_storage; }
+        float get_band_width() const { return m_band_width; }
+        size_t get_memory_usage() const {
+            return m_codes16.capacity() * sizeof(uint16_t) + m_codes8.capacity() * sizeof(uint8_t);
+        }
+        float get_value(int x, int y, int z) const;
+        void set_value(int x, int y, int z, float value);
+        std::vector<float> get_values() const;
+        void set_values(const std::vector<float>& values);
+        ScalarField3D to_field() const;
+
+        // Encode / decode count consecutive grid points starting at linear index begin
+        void encode(size_t begin, int count, const float* values);
+        void decode(size_t begin, int count, float* values) const;
+
+        Vec3 cell_position(int x, int y, int z) const;
+        Vec3 get_cell_size() const;
+        float sample_trilinear(const Vec3& p) const;
+        Vec3 gradient_at(const Vec3& p) const;
+
+        // Field generation methods
+        void clear_field(float value = 0.0f);
+        void apply_sdf(const SdfExpression& expression);
+
+        // Marching cubes over decoded z-slices, two at a time per worker
+        std::shared_ptr<MeshData> generate_mesh(float isolevel = 0.0f) const;
+        std::vector<MCTriangle> extract_triangles(float isolevel = 0.0f) const;
+        void set_extract_settings(const MCExtractSettings& settings) { m_extract_settings = settings; }
+        const MCExtractSettings& get_extract_settings() const { return m_extract_settings; }
+    };
+
+} // namespace alice2
+
+#endif // ALICE2_COMPACT_SCALAR_FIELD_3D_H
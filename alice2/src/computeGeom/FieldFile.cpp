@@ -0,0 +1,246 @@
+#include "FieldFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace alice2 {
+
+    namespace {
+        constexpr uint32_t FIELD_FILE_VERSION = 1;
+        constexpr uint64_t VALUE_ALIGNMENT = 64;
+
+        size_t header_value_count(const FieldFileHeader& header) {
+            return static_cast<size_t>(header.resolution[0]) * header.resolution[1] * header.resolution[2];
+        }
+
+        // Positive resolutions whose value count and float byte size fit in size_t
+        bool valid_resolution(const FieldFileHeader& header) {
+            size_t count = 1;
+            for (int axis = 0; axis < 3; ++axis) {
+                const int32_t res = header.resolution[axis];
+                if (res <= 0 || count > SIZE_MAX / sizeof(float) / static_cast<size_t>(res)) {
+                    return false;
+                }
+                count *= static_cast<size_t>(res);
+            }
+            return true;
+        }
+
+        // Brick edge in points: at least one and no larger than the largest resolution
+        bool valid_brick_size(const FieldFileHeader& header) {
+            const int32_t largest = std::max({header.resolution[0], header.resolution[1], header.resolution[2]});
+            return header.brick_size > 0 && header.brick_size <= static_cast<uint32_t>(largest);
+        }
+
+        // Visit every brick in (z, y, x) order with its point range [lo, hi) per axis
+        template <typename Fn>
+        void for_each_brick(const FieldFileHeader& header, Fn&& fn) {
+            const int size = static_cast<int>(header.brick_size);
+            const int* res = header.resolution;
+            // Ends are clamped before adding so resolutions near INT_MAX cannot overflow
+            auto brick_end = [size](int start, int resolution) {
+                return resolution - start <= size ? resolution : start + size;
+            };
+            for (int z0 = 0; z0 < res[2]; z0 = brick_end(z0, res[2])) {
+                for (int y0 = 0; y0 < res[1]; y0 = brick_end(y0, res[1])) {
+                    for (int x0 = 0; x0 < res[0]; x0 = brick_end(x0, res[0])) {
+                        const int lo[3] = {x0, y0, z0};
+                        const int hi[3] = {brick_end(x0, res[0]), brick_end(y0, res[1]), brick_end(z0, res[2])};
+                        fn(lo, hi);
+                    }
+                }
+            }
+        }
+
+        size_t brick_points(const int lo[3], const int hi[3]) {
+            return static_cast<size_t>(hi[0] - lo[0]) * (hi[1] - lo[1]) * (hi[2] - lo[2]);
+        }
+
+        inline size_t row_index(const FieldFileHeader& header, int x, int y, int z) {
+            return (static_cast<size_t>(z) * header.resolution[1] + y) * header.resolution[0] + x;
+        }
+    }
+
+    bool write_field_file(const std::string& path, const FieldFileHeader& header_in, const float* values,
+                          FieldCompression compression) {
+        FieldFileHeader header = header_in;
+        std::memcpy(header.magic, "A2SF", 4);
+        header.version = FIELD_FILE_VERSION;
+        header.compression = static_cast<uint32_t>(compression);
+        header.value_offset = (sizeof(FieldFileHeader) + VALUE_ALIGNMENT - 1) / VALUE_ALIGNMENT * VALUE_ALIGNMENT;
+        if (!valid_resolution(header)) {
+            return false;
+        }
+        header.brick_size = std::clamp(header.brick_size, 1u,
+            static_cast<uint32_t>(std::max({header.resolution[0], header.resolution[1], header.resolution[2]})));
+
+        // Constant bricks are detected bit for bit so the encoding stays lossless (-0 vs 0, NaN)
+        std::vector<FieldBrickEntry> table;
+        std::vector<float> payload;
+        if (compression == FieldCompression::Brick) {
+            for_each_brick(header, [&](const int lo[3], const int hi[3]) {
+                FieldBrickEntry entry;
+                const float first = values[row_index(header, lo[0], lo[1], lo[2])];
+                bool constant = true;
+                for (int z = lo[2]; z < hi[2] && constant; ++z) {
+                    for (int y = lo[1]; y < hi[1] && constant; ++y) {
+                        const float* row = values + row_index(header, 0, y, z);
+                        for (int x = lo[0]; x < hi[0]; ++x) {
+                            if (std::memcmp(&row[x], &first, sizeof(float)) != 0) {
+                                constant = false;
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                if (constant) {
+                    entry.constant = 1;
+                    entry.value = first;
+                } else {
+                    entry.offset = payload.size();
+                    for (int z = lo[2]; z < hi[2]; ++z) {
+                        for (int y = lo[1]; y < hi[1]; ++y) {
+                            const float* row = values + row_index(header, 0, y, z);
+                            payload.insert(payload.end(), row + lo[0], row + hi[0]);
+                        }
+                    }
+                }
+                table.push_back(entry);
+            });
+            header.value_bytes = table.size() * sizeof(FieldBrickEntry) + payload.size() * sizeof(float);
+        } else {
+            header.value_bytes = header_value_count(header) * sizeof(float);
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        const char padding[VALUE_ALIGNMENT] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding, static_cast<std::streamsize>(header.value_offset - sizeof(header)));
+        if (compression == FieldCompression::Brick) {
+            out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(FieldBrickEntry)));
+            out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size() * sizeof(float)));
+        } else {
+            out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(header.value_bytes));
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool FieldFile::open(const std::string& path) {
+        close();
+        if (!m_file.open(path, MappedFile::Mode::ReadOnly) || m_file.size() < sizeof(FieldFileHeader)) {
+            close();
+            return false;
+        }
+        m_view_bytes = static_cast<size_t>(m_file.size());
+        m_view = static_cast<const char*>(m_file.map(0, m_view_bytes));
+        if (!m_view) {
+            close();
+            return false;
+        }
+
+        std::memcpy(&m_header, m_view, sizeof(FieldFileHeader));
+        const FieldFileHeader& h = m_header;
+        bool valid = std::memcmp(h.magic, "A2SF", 4) == 0 && h.version == FIELD_FILE_VERSION &&
+                     (h.dimensions == 2 || h.dimensions == 3) && valid_resolution(h) &&
+                     (h.dimensions == 3 || h.resolution[2] == 1) &&
+                     h.value_offset % VALUE_ALIGNMENT == 0 && h.value_offset >= sizeof(FieldFileHeader) &&
+                     h.value_offset <= m_view_bytes && h.value_bytes <= m_view_bytes - h.value_offset;
+
+        if (valid && h.compression == static_cast<uint32_t>(FieldCompression::None)) {
+            valid = h.value_bytes == header_value_count(h) * sizeof(float);
+        } else if (valid && h.compression == static_cast<uint32_t>(FieldCompression::Brick) && valid_brick_size(h)) {
+            int counts[3];
+            brick_counts(counts);
+            // Brick count <= value count, which valid_resolution keeps within size_t
+            const size_t brick_total = static_cast<size_t>(counts[0]) * counts[1] * counts[2];
+            valid = brick_total <= h.value_bytes / sizeof(FieldBrickEntry);
+            const size_t table_bytes = valid ? brick_total * sizeof(FieldBrickEntry) : 0;
+            if (valid) {
+                const char* table = m_view + h.value_offset;
+                const size_t payload_floats = (h.value_bytes - table_bytes) / sizeof(float);
+                size_t brick = 0;
+                for_each_brick(h, [&](const int lo[3], const int hi[3]) {
+                    FieldBrickEntry entry;
+                    std::memcpy(&entry, table + brick++ * sizeof(FieldBrickEntry), sizeof(entry));
+                    if (!entry.constant && (entry.offset > payload_floats || brick_points(lo, hi) > payload_floats - entry.offset)) {
+                        valid = false;
+                    }
+                });
+            }
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            close();
+        }
+        return valid;
+    }
+
+    void FieldFile::close() {
+        MappedFile::unmap(const_cast<char*>(m_view), m_view_bytes);
+        m_view = nullptr;
+        m_view_bytes = 0;
+        m_file.close();
+        m_header = FieldFileHeader();
+    }
+
+    size_t FieldFile::value_count() const {
+        return m_view ? header_value_count(m_header) : 0;
+    }
+
+    void FieldFile::brick_counts(int counts[3]) const {
+        const int size = static_cast<int>(m_header.brick_size);
+        for (int axis = 0; axis < 3; ++axis) {
+            counts[axis] = m_header.resolution[axis] / size + (m_header.resolution[axis] % size != 0 ? 1 : 0);
+        }
+    }
+
+    std::span<const float> FieldFile::raw_values() const {
+        if (!m_view || m_header.compression != static_cast<uint32_t>(FieldCompression::None)) {
+            return {};
+        }
+        return {reinterpret_cast<const float*>(m_view + m_header.value_offset), value_count()};
+    }
+
+    void FieldFile::read_values(float* out) const {
+        if (!m_view) {
+            return;
+        }
+        if (m_header.compression == static_cast<uint32_t>(FieldCompression::None)) {
+            std::memcpy(out, m_view + m_header.value_offset, value_count() * sizeof(float));
+            return;
+        }
+
+        int counts[3];
+        brick_counts(counts);
+        const char* table = m_view + m_header.value_offset;
+        const float* payload = reinterpret_cast<const float*>(
+            table + static_cast<size_t>(counts[0]) * counts[1] * counts[2] * sizeof(FieldBrickEntry));
+        size_t brick = 0;
+        for_each_brick(m_header, [&](const int lo[3], const int hi[3]) {
+            FieldBrickEntry entry;
+            std::memcpy(&entry, table + brick++ * sizeof(FieldBrickEntry), sizeof(entry));
+            const float* source = payload + entry.offset;
+            const int width = hi[0] - lo[0];
+            for (int z = lo[2]; z < hi[2]; ++z) {
+                for (int y = lo[1]; y < hi[1]; ++y) {
+                    float* row = out + row_index(m_header, lo[0], y, z);
+                    if (entry.constant) {
+                        std::fill(row, row + width, entry.value);
+                    } else {
+                        std::memcpy(row, source, width * sizeof(float));
+                        source += width;
+                    }
+                }
+            }
+        });
+    }
+
+} // namespace alice2
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef ALICE2_FIELD_FILE_H
+#define ALICE2_FIELD_FILE_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include "../utils/MappedFile.h"
+
+namespace alice2 {
+
+    enum class FieldCompression : uint32_t {
+        None = 0,   // values stored as one array in grid order
+        Brick = 1   // values split into bricks; bricks holding a single value store just that value
+    };
+
+    /**
+     * Binary field file layout (native byte order, little-endian on all supported targets):
+     *   FieldFileHeader
+     *   value section at value_offset (64-byte aligned):
+     *     None:  resolution product floats, x fastest
+     *     Brick: one FieldBrickEntry per brick ((z, y, x) order), then the payload of the
+     *            non-constant bricks, each x fastest and clipped to the grid
+     */
+    struct FieldFileHeader {
+        char magic[4] = {'A', '2', 'S', 'F'};
+        uint32_t version = 1;
+        uint32_t dimensions = 3;            // 2 or 3
+        uint32_t compression = 0;           // FieldCompression
+        int32_t resolution[3] = {1, 1, 1};  // unused axes are 1
+        uint32_t brick_size = 8;            // points per brick edge (Brick compression)
+        float min_bounds[3] = {0, 0, 0};
+        float max_bounds[3] = {0, 0, 0};
+        float grid_origin[3] = {0, 0, 0};   // implicit grid: origin + index * step
+        float grid_step[3] = {0, 0, 0};
+        float transform[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};    // 2D point transform
+        uint32_t has_transform = 0;
+        uint32_t reserved = 0;
+        uint64_t value_offset = 0;
+        uint64_t value_bytes = 0;
+    };
+    static_assert(sizeof(FieldFileHeader) == 168, "FieldFileHeader layout is part of the file format");
+
+    struct FieldBrickEntry {
+        uint32_t constant = 0;  // 1: every point of the brick holds value
+        float value = 0.0f;
+        uint64_t offset = 0;    // first float of the brick in the payload otherwise
+    };
+    static_assert(sizeof(FieldBrickEntry) == 16, "FieldBrickEntry layout is part of the file format");
+
+    // Write values (resolution product floats, grid order) under the given header. The format
+    // fields of the header (magic, version, compression, offsets) are filled in here.
+    bool write_field_file(const std::string& path, const FieldFileHeader& header, const float* values,
+                          FieldCompression compression = FieldCompression::None);
+
+    /**
+     * Read-only view of a field file. The whole file is memory-mapped; uncompressed values are
+     * used in place, so opening costs only the header validation and pages are read on demand.
+     */
+    class FieldFile {
+    public:
+        FieldFile() = default;
+        ~FieldFile() { close(); }
+        FieldFile(const FieldFile& other) = delete;
+        FieldFile& operator=(const FieldFile& other) = delete;
+
+        // Map the file and validate its header and brick table
+        bool open(const std::string& path);
+        void close();
+
+        const FieldFileHeader& header() const { return m_header; }
+        size_t value_count() const;
+        // Values in grid order straight from the mapping; empty for brick-compressed files
+        std::span<const float> raw_values() const;
+        // Copy (None) or decode (Brick) all values into out, which holds value_count() floats
+        void read_values(float* out) const;
+
+    private:
+        MappedFile m_file;
+        const char* m_view = nullptr;
+        size_t m_view_bytes = 0;
+        FieldFileHeader m_header;
+
+        // Bricks per axis for the header's resolution
+        void brick_counts(int counts[3]) const;
+    };
+
+} // namespace alice2
+
+#endif // ALICE2_FIELD_FILE_H
@@ -1,14 +1,20 @@
 #include "scalarField3D.h"
 #include "../objects/MeshObject.h"
 #include "../core/Renderer.h"
+#include "SdfExpression.h"
+#include "../utils/Parallel.h"
+#include "../utils/Simd.h"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <limits>
+#include <mutex>
 #include <set>
 
 namespace alice2 {
 
     // Marching cubes edge table - maps vertex configuration to intersected edges
-    const int EDGE_TABLE[256] = {
+    constexpr int EDGE_TABLE[256] = {
         0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
         0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
         0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
@@ -44,7 +50,7 @@ namespace alice2 {
     };
 
     // Complete marching cubes triangle table - all 256 entries
-    const int TRI_TABLE[256][16] = {
+    constexpr int TRI_TABLE[256][16] = {
         {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
         {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
         {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
@@ -303,6 +309,227 @@ namespace alice2 {
         {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
     };
 
+    // Output of one z-slab of an indexed extraction. Boundary slots address the grid edges
+    // lying on a slab's bottom or top layer; a vertex on a layer shared with a neighbouring
+    // slab is created by both slabs and resolved to a single vertex when slabs are merged.
+    struct MCMeshSlab {
+        std::vector<Vec3> positions;
+        std::vector<int> indices;           // local vertex ids, polygon_size per face
+        std::vector<int> owned_boundary;    // slot -> local id of a vertex this slab owns, or -1
+        std::vector<int> shared_boundary;   // slot -> local id of a duplicate owned by the neighbour, or -1
+    };
+
+    // Bricks that may contain a given isolevel, plus per brick-row (by, bz) and per brick-layer
+    // flags so whole rows and layers of empty bricks can be stepped over.
+    struct MCBrickMask {
+        int bricks_x = 0;
+        int bricks_y = 0;
+        int bricks_z = 0;
+        int active_bricks = 0;
+        std::vector<unsigned char> bricks;
+        std::vector<unsigned char> rows;
+        std::vector<unsigned char> layers;
+    };
+
+    // Octree over cells used by adaptive extraction. A node covers cells [x0, x0 + size) per axis
+    // (size a power of two); children are ordered x fastest and are -1 where they fall outside
+    // the grid. Leaves keep their children at -1.
+    struct MCOctreeNode {
+        int x0, y0, z0, size;
+        int children[8];
+        bool leaf;
+        bool has_surface;
+    };
+
+    struct MCOctree {
+        std::vector<MCOctreeNode> nodes;
+        int root = -1;
+
+        // Leaf containing cell (x, y, z), or -1 outside the grid
+        int locate(int x, int y, int z) const {
+            int node = root;
+            while (node >= 0 && !nodes[node].leaf) {
+                const MCOctreeNode& n = nodes[node];
+                const int half = n.size / 2;
+                const int child = (x - n.x0 >= half ? 1 : 0) | (y - n.y0 >= half ? 2 : 0) | (z - n.z0 >= half ? 4 : 0);
+                node = n.children[child];
+            }
+            return node;
+        }
+    };
+
+    // Grid edge addressed by each of the 12 marching cubes edges, relative to the cell origin.
+    // cache: 0 = x/y edges of the lower layer, 1 = x/y edges of the upper layer, 2 = z-edges.
+    // Corners are listed in canonical (ascending) order so shared edges interpolate identically.
+    struct MCEdgeRef {
+        int cache;
+        int axis;
+        int di;
+        int dj;
+        int corner_a;
+        int corner_b;
+    };
+
+    static constexpr MCEdgeRef MC_EDGE_REFS[12] = {
+        {0, 0, 0, 0, 0, 1}, {0, 1, 1, 0, 1, 2}, {0, 0, 0, 1, 3, 2}, {0, 1, 0, 0, 0, 3},
+        {1, 0, 0, 0, 4, 5}, {1, 1, 1, 0, 5, 6}, {1, 0, 0, 1, 7, 6}, {1, 1, 0, 0, 4, 7},
+        {2, 0, 0, 0, 0, 4}, {2, 0, 1, 0, 1, 5}, {2, 0, 1, 1, 2, 6}, {2, 0, 0, 1, 3, 7}
+    };
+
+    // Corner offsets of a marching cubes cell in standard vertex order
+    static constexpr int MC_CORNER_OFFSETS[8][3] = {
+        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+        {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+    };
+
+    // Corner pair of each marching cubes edge, in the orientation polygonize_cell interpolates it
+    static constexpr int MC_CELL_EDGE_CORNERS[12][2] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6},
+        {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}
+    };
+
+    // Per-case tables for the strided kernel, built at compile time: crossed-edge masks are
+    // derived from the cube topology (and checked against EDGE_TABLE), and triangle lists are
+    // stored with their length so the kernel never scans for the -1 terminator.
+    struct MCCaseTables {
+        uint16_t edge_mask[256];
+        uint8_t triangle_count[256];
+        uint8_t edges[256][15];
+    };
+
+    static constexpr MCCaseTables build_mc_case_tables() {
+        MCCaseTables tables{};
+        for (int cube = 0; cube < 256; ++cube) {
+            int mask = 0;
+            for (int e = 0; e < 12; ++e) {
+                const int a = (cube >> MC_CELL_EDGE_CORNERS[e][0]) & 1;
+                const int b = (cube >> MC_CELL_EDGE_CORNERS[e][1]) & 1;
+                if (a != b) mask |= 1 << e;
+            }
+            if (mask != EDGE_TABLE[cube]) {
+                throw std::logic_error("EDGE_TABLE does not match the cube topology");
+            }
+            tables.edge_mask[cube] = static_cast<uint16_t>(mask);
+
+            int n = 0;
+            while (n < 15 && TRI_TABLE[cube][n] != -1) {
+                tables.edges[cube][n] = static_cast<uint8_t>(TRI_TABLE[cube][n]);
+                ++n;
+            }
+            tables.triangle_count[cube] = static_cast<uint8_t>(n / 3);
+        }
+        return tables;
+    }
+
+    static constexpr MCCaseTables MC_CASES = build_mc_case_tables();
+
+    // Merge slab meshes into one indexed mesh. Duplicated boundary vertices are mapped to the
+    // vertex owned by the neighbouring slab (next slab if shared_from_next, else previous).
+    // Vertex normals are area-weighted face normals.
+    static void merge_mesh_slabs(const std::vector<MCMeshSlab>& slabs, bool shared_from_next,
+                                 int polygon_size, MeshData& mesh) {
+        const int slab_count = static_cast<int>(slabs.size());
+        std::vector<std::vector<int>> local_to_global(slab_count);
+
+        // Owned vertices get consecutive global ids in slab order
+        int vertex_count = 0;
+        for (int s = 0; s < slab_count; ++s) {
+            const MCMeshSlab& slab = slabs[s];
+            const int neighbour = shared_from_next ? s + 1 : s - 1;
+            std::vector<int>& mapping = local_to_global[s];
+            mapping.assign(slab.positions.size(), 0);
+
+            if (neighbour >= 0 && neighbour < slab_count) {
+                const std::vector<int>& owner = slabs[neighbour].owned_boundary;
+                for (size_t slot = 0; slot < slab.shared_boundary.size(); ++slot) {
+                    const int local = slab.shared_boundary[slot];
+                    if (local >= 0 && slot < owner.size() && owner[slot] >= 0) {
+                        mapping[local] = -1;
+                    }
+                }
+            }
+
+            for (int& id : mapping) {
+                id = (id == 0) ? vertex_count++ : -1;
+            }
+        }
+
+        // Duplicates take the id their neighbour assigned
+        for (int s = 0; s < slab_count; ++s) {
+            const int neighbour = shared_from_next ? s + 1 : s - 1;
+            if (neighbour < 0 || neighbour >= slab_count) {
+                continue;
+            }
+            const MCMeshSlab& slab = slabs[s];
+            const std::vector<int>& owner = slabs[neighbour].owned_boundary;
+            for (size_t slot = 0; slot < slab.shared_boundary.size(); ++slot) {
+                const int local = slab.shared_boundary[slot];
+                if (local >= 0 && local_to_global[s][local] < 0) {
+                    local_to_global[s][local] = local_to_global[neighbour][owner[slot]];
+                }
+            }
+        }
+
+        const Color color(0.8f, 0.8f, 0.9f);
+        mesh.vertices.resize(vertex_count);
+        for (int s = 0; s < slab_count; ++s) {
+            const MCMeshSlab& slab = slabs[s];
+            for (size_t local = 0; local < slab.positions.size(); ++local) {
+                const int global = local_to_global[s][local];
+                if (global >= 0 && global < vertex_count) {
+                    MeshVertex& vertex = mesh.vertices[global];
+                    vertex.position = slab.positions[local];
+                    vertex.normal = Vec3(0, 0, 0);
+                    vertex.color = color;
+                }
+            }
+        }
+
+        size_t face_count = 0;
+        for (const auto& slab : slabs) {
+            face_count += slab.indices.size() / polygon_size;
+        }
+        mesh.faces.reserve(face_count);
+        mesh.triangleIndices.reserve(face_count * (polygon_size - 2) * 3);
+
+        for (int s = 0; s < slab_count; ++s) {
+            const MCMeshSlab& slab = slabs[s];
+            for (size_t base = 0; base + polygon_size <= slab.indices.size(); base += polygon_size) {
+                MeshFace face;
+                face.vertices.resize(polygon_size);
+                for (int c = 0; c < polygon_size; ++c) {
+                    face.vertices[c] = local_to_global[s][slab.indices[base + c]];
+                }
+
+                // Newell normal handles triangles and (possibly non-planar) quads alike
+                Vec3 normal(0, 0, 0);
+                for (int c = 0; c < polygon_size; ++c) {
+                    const Vec3& a = mesh.vertices[face.vertices[c]].position;
+                    const Vec3& b = mesh.vertices[face.vertices[(c + 1) % polygon_size]].position;
+                    normal += a.cross(b);
+                }
+                for (int c = 0; c < polygon_size; ++c) {
+                    mesh.vertices[face.vertices[c]].normal += normal;
+                }
+                face.normal = normal.normalized();
+                face.color = color;
+
+                for (int c = 1; c + 1 < polygon_size; ++c) {
+                    mesh.triangleIndices.push_back(face.vertices[0]);
+                    mesh.triangleIndices.push_back(face.vertices[c]);
+                    mesh.triangleIndices.push_back(face.vertices[c + 1]);
+                }
+                mesh.faces.push_back(std::move(face));
+            }
+        }
+
+        for (auto& vertex : mesh.vertices) {
+            const float length = vertex.normal.length();
+            vertex.normal = (length > 1e-12f) ? vertex.normal / length : Vec3(0, 0, 1);
+        }
+        mesh.triangulationDirty = false;
+    }
+
     // Constructor
     ScalarField3D::ScalarField3D(const Vec3& min_bb, const Vec3& max_bb, int res_x, int res_y, int res_z)
         : m_min_bounds(min_bb), m_max_bounds(max_bb), m_res_x(res_x), m_res_y(res_y), m_res_z(res_z) {
@@ -311,9 +538,8 @@ namespace alice2 {
         }
 
         const int total_points = m_res_x * m_res_y * m_res_z;
-        m_grid_points.reserve(total_points);
         m_field_values.resize(total_points, 0.0f);
-        m_normalized_values.resize(total_points, 0.0f);
+        m_brick_versions.assign(static_cast<size_t>(brick_count(m_res_x)) * brick_count(m_res_y) * brick_count(m_res_z), 0);
 
         initialize_grid();
     }
@@ -322,22 +548,50 @@ namespace alice2 {
     ScalarField3D::ScalarField3D(const ScalarField3D& other)
         : m_min_bounds(other.m_min_bounds), m_max_bounds(other.m_max_bounds)
         , m_res_x(other.m_res_x), m_res_y(other.m_res_y), m_res_z(other.m_res_z)
-        , m_grid_points(other.m_grid_points)
+        , m_grid_step(other.m_grid_step)
+        , m_custom_points(other.m_custom_points)
         , m_field_values(other.m_field_values)
-        , m_normalized_values(other.m_normalized_values) {
+        , m_normalized_min(other.m_normalized_min)
+        , m_normalized_scale(other.m_normalized_scale)
+        , m_normalized_dirty(other.m_normalized_dirty)
+        , m_extract_settings(other.m_extract_settings)
+        , m_bricks(other.m_bricks)
+        , m_bricks_dirty(other.m_bricks_dirty)
+        , m_bricks_version(other.m_bricks_version)
+        , m_write_version(other.m_write_version)
+        , m_full_write_version(other.m_full_write_version)
+        , m_brick_versions(other.m_brick_versions)
+        , m_gradient_cache_enabled(other.m_gradient_cache_enabled)
+        , m_gradient_field(other.m_gradient_field)
+        , m_gradient_version(other.m_gradient_version)
+        , m_gradient_synced(other.m_gradient_synced.load()) {
     }
 
     // Copy assignment operator
     ScalarField3D& ScalarField3D::operator=(const ScalarField3D& other) {
         if (this != &other) {
+            // Versions restart past both operands so incremental/progressive meshes built from
+            // either field see every brick as changed
+            const uint64_t version = std::max(m_write_version, other.m_write_version) + 1;
+            const bool bricks_current = !other.m_bricks_dirty && other.m_bricks_version == other.m_write_version;
+            const bool gradient_current = other.m_gradient_version == other.m_write_version;
             m_min_bounds = other.m_min_bounds;
             m_max_bounds = other.m_max_bounds;
             m_res_x = other.m_res_x;
             m_res_y = other.m_res_y;
             m_res_z = other.m_res_z;
-            m_grid_points = other.m_grid_points;
+            m_grid_step = other.m_grid_step;
+            m_custom_points = other.m_custom_points;
+            m_points_cache.clear();
             m_field_values = other.m_field_values;
-            m_normalized_values = other.m_normalized_values;
+            m_normalized_min = other.m_normalized_min;
+            m_normalized_scale = other.m_normalized_scale;
+            m_normalized_dirty = other.m_normalized_dirty;
+            m_extract_settings = other.m_extract_settings;
+            m_bricks = other.m_bricks;
+            m_gradient_cache_enabled = other.m_gradient_cache_enabled;
+            m_gradient_field = other.m_gradient_field;
+            restamp_versions(version, bricks_current, gradient_current);
         }
         return *this;
     }
@@ -346,22 +600,50 @@ namespace alice2 {
     ScalarField3D::ScalarField3D(ScalarField3D&& other) noexcept
         : m_min_bounds(other.m_min_bounds), m_max_bounds(other.m_max_bounds)
         , m_res_x(other.m_res_x), m_res_y(other.m_res_y), m_res_z(other.m_res_z)
-        , m_grid_points(std::move(other.m_grid_points))
+        , m_grid_step(other.m_grid_step)
+        , m_custom_points(std::move(other.m_custom_points))
+        , m_points_cache(std::move(other.m_points_cache))
         , m_field_values(std::move(other.m_field_values))
-        , m_normalized_values(std::move(other.m_normalized_values)) {
+        , m_normalized_min(other.m_normalized_min)
+        , m_normalized_scale(other.m_normalized_scale)
+        , m_normalized_dirty(other.m_normalized_dirty)
+        , m_extract_settings(other.m_extract_settings)
+        , m_bricks(std::move(other.m_bricks))
+        , m_bricks_dirty(other.m_bricks_dirty)
+        , m_bricks_version(other.m_bricks_version)
+        , m_write_version(other.m_write_version)
+        , m_full_write_version(other.m_full_write_version)
+        , m_brick_versions(std::move(other.m_brick_versions))
+        , m_gradient_cache_enabled(other.m_gradient_cache_enabled)
+        , m_gradient_field(std::move(other.m_gradient_field))
+        , m_gradient_version(other.m_gradient_version)
+        , m_gradient_synced(other.m_gradient_synced.load()) {
     }
 
     // Move assignment operator
     ScalarField3D& ScalarField3D::operator=(ScalarField3D&& other) noexcept {
         if (this != &other) {
+            // Same version restamp as copy assignment
+            const uint64_t version = std::max(m_write_version, other.m_write_version) + 1;
+            const bool bricks_current = !other.m_bricks_dirty && other.m_bricks_version == other.m_write_version;
+            const bool gradient_current = other.m_gradient_version == other.m_write_version;
             m_min_bounds = other.m_min_bounds;
             m_max_bounds = other.m_max_bounds;
             m_res_x = other.m_res_x;
             m_res_y = other.m_res_y;
             m_res_z = other.m_res_z;
-            m_grid_points = std::move(other.m_grid_points);
+            m_grid_step = other.m_grid_step;
+            m_custom_points = std::move(other.m_custom_points);
+            m_points_cache = std::move(other.m_points_cache);
             m_field_values = std::move(other.m_field_values);
-            m_normalized_values = std::move(other.m_normalized_values);
+            m_normalized_min = other.m_normalized_min;
+            m_normalized_scale = other.m_normalized_scale;
+            m_normalized_dirty = other.m_normalized_dirty;
+            m_extract_settings = other.m_extract_settings;
+            m_bricks = std::move(other.m_bricks);
+            m_gradient_cache_enabled = other.m_gradient_cache_enabled;
+            m_gradient_field = std::move(other.m_gradient_field);
+            restamp_versions(version, bricks_current, gradient_current);
         }
         return *this;
     }
@@ -380,40 +662,197 @@ namespace alice2 {
         );
     }
 
+    // Grid points are implicit: only the spacing is stored and positions are derived per access
     void ScalarField3D::initialize_grid() {
-        m_grid_points.clear();
-        
-        const Vec3 step = Vec3(
-            (m_max_bounds.x - m_min_bounds.x) / (m_res_x - 1),
-            (m_max_bounds.y - m_min_bounds.y) / (m_res_y - 1),
-            (m_max_bounds.z - m_min_bounds.z) / (m_res_z - 1)
-        );
+        m_custom_points.clear();
+        m_points_cache.clear();
+        m_grid_step = get_cell_size();
+    }
 
-        for (int k = 0; k < m_res_z; ++k) {
-            for (int j = 0; j < m_res_y; ++j) {
-                for (int i = 0; i < m_res_x; ++i) {
-                    Vec3 point = m_min_bounds + Vec3(i * step.x, j * step.y, k * step.z);
-                    m_grid_points.push_back(point);
+    // Compatibility view of all grid point positions, built on first use
+    const std::vector<Vec3>& ScalarField3D::get_points() const {
+        if (!m_custom_points.empty()) {
+            return m_custom_points;
+        }
+        if (m_points_cache.empty()) {
+            m_points_cache.reserve(m_field_values.size());
+            for (int k = 0; k < m_res_z; ++k) {
+                for (int j = 0; j < m_res_y; ++j) {
+                    for (int i = 0; i < m_res_x; ++i) {
+                        m_points_cache.push_back(grid_point(i, j, k));
+                    }
                 }
             }
         }
+        return m_points_cache;
     }
 
-    void ScalarField3D::normalize_field() {
-        if (m_field_values.empty()) return;
+    // Override the implicit grid with explicit positions (one per grid point, in index order).
+    // An empty vector restores the implicit grid.
+    void ScalarField3D::set_points(const std::vector<Vec3>& grid_points) {
+        if (!grid_points.empty() && grid_points.size() != m_field_values.size()) {
+            throw std::invalid_argument("Points size must match grid size");
+        }
+        m_custom_points = grid_points;
+        m_points_cache.clear();
+        m_full_write_version = ++m_write_version;   // vertex positions of every brick change
+    }
+
+    // Refresh the [0, 1] mapping used for drawing; runs only when values changed since the last
+    // call. Normalized values are derived per point instead of being stored.
+    void ScalarField3D::normalize_field() const {
+        if (!m_normalized_dirty || m_field_values.empty()) return;
+        m_normalized_dirty = false;
 
         auto [min_it, max_it] = std::minmax_element(m_field_values.begin(), m_field_values.end());
-        float min_val = *min_it;
-        float max_val = *max_it;
-        
-        if (std::abs(max_val - min_val) < 1e-6f) {
-            std::fill(m_normalized_values.begin(), m_normalized_values.end(), 0.0f);
+        const float range = *max_it - *min_it;
+        m_normalized_min = *min_it;
+        m_normalized_scale = std::abs(range) < 1e-6f ? 0.0f : 1.0f / range;
+    }
+
+    // Called after every write to m_field_values; derived data is rebuilt lazily on next use
+    void ScalarField3D::on_values_changed() {
+        m_normalized_dirty = true;
+        m_bricks_dirty = true;
+        m_full_write_version = ++m_write_version;
+    }
+
+    // Gives every brick the same fresh version after the grid was replaced wholesale; caches
+    // that were current for the source field stay valid under the new version
+    void ScalarField3D::restamp_versions(uint64_t version, bool bricks_current, bool gradient_current) {
+        m_write_version = version;
+        m_full_write_version = version;
+        m_brick_versions.assign(static_cast<size_t>(brick_count(m_res_x)) * brick_count(m_res_y) * brick_count(m_res_z), version);
+        m_bricks_dirty = !bricks_current;
+        m_bricks_version = version;
+        m_gradient_version = gradient_current ? version : 0;
+        m_gradient_synced = gradient_current ? version + 1 : 0;
+    }
+
+    // Called after writing grid points [x0, x1] x [y0, y1] x [z0, z1] (inclusive). Stamps every
+    // brick with a cell touching the region; their summaries are refreshed on next use.
+    void ScalarField3D::on_region_changed(int x0, int y0, int z0, int x1, int y1, int z1) {
+        const int bricks_x = brick_count(m_res_x);
+        const int bricks_y = brick_count(m_res_y);
+        const int bricks_z = brick_count(m_res_z);
+        const uint64_t version = ++m_write_version;
+
+        // Point p is a corner of cells p - 1 and p
+        const int bx1 = std::min(bricks_x - 1, x1 / BRICK_SIZE);
+        const int by1 = std::min(bricks_y - 1, y1 / BRICK_SIZE);
+        const int bz1 = std::min(bricks_z - 1, z1 / BRICK_SIZE);
+        for (int bz = std::max(0, z0 - 1) / BRICK_SIZE; bz <= bz1; ++bz) {
+            for (int by = std::max(0, y0 - 1) / BRICK_SIZE; by <= by1; ++by) {
+                for (int bx = std::max(0, x0 - 1) / BRICK_SIZE; bx <= bx1; ++bx) {
+                    m_brick_versions[(static_cast<size_t>(bz) * bricks_y + by) * bricks_x + bx] = version;
+                }
+            }
+        }
+        m_normalized_dirty = true;
+    }
+
+    // Min/max over the BRICK_SIZE + 1 grid points per axis of one brick, including the far corners
+    void ScalarField3D::update_brick(int bx, int by, int bz) const {
+        const int i_begin = bx * BRICK_SIZE;
+        const int j_begin = by * BRICK_SIZE;
+        const int k_begin = bz * BRICK_SIZE;
+        const int i_end = std::min(m_res_x - 1, i_begin + BRICK_SIZE);
+        const int j_end = std::min(m_res_y - 1, j_begin + BRICK_SIZE);
+        const int k_end = std::min(m_res_z - 1, k_begin + BRICK_SIZE);
+
+        float min_value = m_field_values[get_index(i_begin, j_begin, k_begin)];
+        float max_value = min_value;
+        for (int k = k_begin; k <= k_end; ++k) {
+            for (int j = j_begin; j <= j_end; ++j) {
+                const float* row = &m_field_values[get_index(0, j, k)];
+                for (int i = i_begin; i <= i_end; ++i) {
+                    min_value = std::min(min_value, row[i]);
+                    max_value = std::max(max_value, row[i]);
+                }
+            }
+        }
+
+        FieldBrick& brick = m_bricks[(static_cast<size_t>(bz) * brick_count(m_res_y) + by) * brick_count(m_res_x) + bx];
+        brick.min_value = min_value;
+        brick.max_value = max_value;
+    }
+
+    // Bring the brick summaries up to date: all bricks after a full write, otherwise only the
+    // bricks stamped by regional writes since the last refresh.
+    void ScalarField3D::update_bricks() const {
+        const int bricks_x = brick_count(m_res_x);
+        const int bricks_y = brick_count(m_res_y);
+        const int bricks_z = brick_count(m_res_z);
+
+        if (!m_bricks_dirty) {
+            if (m_bricks_version == m_write_version) return;
+            for (int bz = 0; bz < bricks_z; ++bz) {
+                for (int by = 0; by < bricks_y; ++by) {
+                    for (int bx = 0; bx < bricks_x; ++bx) {
+                        if (m_brick_versions[(static_cast<size_t>(bz) * bricks_y + by) * bricks_x + bx] > m_bricks_version) {
+                            update_brick(bx, by, bz);
+                        }
+                    }
+                }
+            }
+            m_bricks_version = m_write_version;
             return;
         }
 
-        float range = max_val - min_val;
-        for (size_t i = 0; i < m_field_values.size(); ++i) {
-            m_normalized_values[i] = (m_field_values[i] - min_val) / range;
+        m_bricks.assign(static_cast<size_t>(bricks_x) * bricks_y * bricks_z, FieldBrick());
+
+        parallel_for(bricks_z, m_extract_settings.num_threads, [&](int bz) {
+            for (int by = 0; by < bricks_y; ++by) {
+                for (int bx = 0; bx < bricks_x; ++bx) {
+                    update_brick(bx, by, bz);
+                }
+            }
+        });
+
+        m_bricks_dirty = false;
+        m_bricks_version = m_write_version;
+    }
+
+    // Flag the bricks that may contain the isolevel. A brick whose corners all classify the same
+    // way yields cube index 0 or 255 in every cell, so it can be skipped entirely.
+    void ScalarField3D::build_brick_mask(float isolevel, MCBrickMask& mask) const {
+        build_brick_mask(std::span<const float>(&isolevel, 1), mask);
+    }
+
+    // Isolevels whose surface may cross a range of values: min classifies negative, max does not.
+    // Both tests are monotonic over ascending levels, so the levels form one contiguous run.
+    std::pair<size_t, size_t> ScalarField3D::crossing_levels(std::span<const float> sorted_isolevels,
+                                                             float min_value, float max_value) {
+        auto not_negative = [](float value) {
+            return [value](float level) {
+                return classify_vertex(value, level) != alice2::VertexClass::NEGATIVE;
+            };
+        };
+        const auto first = std::partition_point(sorted_isolevels.begin(), sorted_isolevels.end(), not_negative(min_value));
+        const auto last = std::partition_point(first, sorted_isolevels.end(), not_negative(max_value));
+        return {static_cast<size_t>(first - sorted_isolevels.begin()), static_cast<size_t>(last - sorted_isolevels.begin())};
+    }
+
+    // Multi-level mask: a brick is active if any of the (ascending) isolevels crosses its range
+    void ScalarField3D::build_brick_mask(std::span<const float> sorted_isolevels, MCBrickMask& mask) const {
+        update_bricks();
+
+        mask.bricks_x = brick_count(m_res_x);
+        mask.bricks_y = brick_count(m_res_y);
+        mask.bricks_z = brick_count(m_res_z);
+        mask.bricks.assign(m_bricks.size(), 0);
+        mask.rows.assign(static_cast<size_t>(mask.bricks_y) * mask.bricks_z, 0);
+        mask.layers.assign(mask.bricks_z, 0);
+
+        for (size_t b = 0; b < m_bricks.size(); ++b) {
+            const auto [first, last] = crossing_levels(sorted_isolevels, m_bricks[b].min_value, m_bricks[b].max_value);
+            if (first == last) continue;
+
+            const size_t row = b / mask.bricks_x;
+            mask.bricks[b] = 1;
+            mask.rows[row] = 1;
+            mask.layers[row / mask.bricks_y] = 1;
+            mask.active_bricks++;
         }
     }
 
@@ -422,15 +861,59 @@ namespace alice2 {
             throw std::invalid_argument("Values size must match grid size");
         }
         m_field_values = values;
-        normalize_field();
+        on_values_changed();
+    }
+
+    bool ScalarField3D::save(const std::string& path, FieldCompression compression) const {
+        FieldFileHeader header;
+        header.dimensions = 3;
+        header.resolution[0] = m_res_x;
+        header.resolution[1] = m_res_y;
+        header.resolution[2] = m_res_z;
+        header.brick_size = BRICK_SIZE;
+        const Vec3 vectors[4] = {m_min_bounds, m_max_bounds, m_min_bounds, m_grid_step};
+        float* targets[4] = {header.min_bounds, header.max_bounds, header.grid_origin, header.grid_step};
+        for (int n = 0; n < 4; ++n) {
+            targets[n][0] = vectors[n].x;
+            targets[n][1] = vectors[n].y;
+            targets[n][2] = vectors[n].z;
+        }
+        return write_field_file(path, header, m_field_values.data(), compression);
+    }
+
+    // The file is memory-mapped and its values copied (or decoded) straight into the new grid,
+    // so loading costs one pass over the data with no parsing
+    bool ScalarField3D::load(const std::string& path) {
+        FieldFile file;
+        if (!file.open(path) || file.header().dimensions != 3) {
+            return false;
+        }
+
+        const FieldFileHeader& header = file.header();
+        ScalarField3D loaded(Vec3(header.min_bounds[0], header.min_bounds[1], header.min_bounds[2]),
+                             Vec3(header.max_bounds[0], header.max_bounds[1], header.max_bounds[2]),
+                             header.resolution[0], header.resolution[1], header.resolution[2]);
+        file.read_values(loaded.m_field_values.data());
+        loaded.m_extract_settings = m_extract_settings;
+        loaded.m_gradient_cache_enabled = m_gradient_cache_enabled;
+        *this = std::move(loaded);
+        on_values_changed();
+        return true;
+    }
+
+    void ScalarField3D::set_value(int x, int y, int z, float value) {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        m_field_values[get_index(x, y, z)] = value;
+        on_region_changed(x, y, z, x, y, z);
     }
 
     Vec3 ScalarField3D::cell_position(int x, int y, int z) const {
         if (!is_valid_coords(x, y, z)) {
             throw std::out_of_range("Invalid grid coordinates");
         }
-        int index = get_index(x, y, z);
-        return m_grid_points[index];
+        return grid_point(x, y, z);
     }
 
     Vec3 ScalarField3D::get_cell_size() const {
@@ -458,9 +941,9 @@ namespace alice2 {
         return m_field_values[get_index(ix, iy, iz)];
     }
 
-    void ScalarField3D::clear_field() {
-        std::fill(m_field_values.begin(), m_field_values.end(), 0.0f);
-        std::fill(m_normalized_values.begin(), m_normalized_values.end(), 0.0f);
+    void ScalarField3D::clear_field(float value) {
+        std::fill(m_field_values.begin(), m_field_values.end(), value);
+        on_values_changed();
     }
 
     // Apply scalar sphere to field
@@ -469,14 +952,14 @@ namespace alice2 {
             for (int j = 0; j < m_res_y; ++j) {
                 for (int i = 0; i < m_res_x; ++i) {
                     const int idx = get_index(i, j, k);
-                    const Vec3& pt = m_grid_points[idx];
+                    const Vec3 pt = grid_point(i, j, k);
                     const float distance = (pt - center).length();
                     const float sdf = distance - radius; // SDF: negative inside, positive outside
                     m_field_values[idx] = sdf;
                 }
             }
         }
-        normalize_field();
+        on_values_changed();
     }
 
     // Apply scalar box to field
@@ -485,7 +968,7 @@ namespace alice2 {
             for (int j = 0; j < m_res_y; ++j) {
                 for (int i = 0; i < m_res_x; ++i) {
                     const int idx = get_index(i, j, k);
-                    const Vec3& pt = m_grid_points[idx];
+                    const Vec3 pt = grid_point(i, j, k);
                     const Vec3 d = Vec3(
                         std::abs(pt.x - center.x) - half_size.x,
                         std::abs(pt.y - center.y) - half_size.y,
@@ -497,7 +980,7 @@ namespace alice2 {
                 }
             }
         }
-        normalize_field();
+        on_values_changed();
     }
 
     // Apply scalar torus to field
@@ -506,7 +989,7 @@ namespace alice2 {
             for (int j = 0; j < m_res_y; ++j) {
                 for (int i = 0; i < m_res_x; ++i) {
                     const int idx = get_index(i, j, k);
-                    const Vec3& pt = m_grid_points[idx];
+                    const Vec3 pt = grid_point(i, j, k);
                     const Vec3 offset = pt - center;
                     const float q = std::sqrt(offset.x * offset.x + offset.y * offset.y) - major_radius;
                     const float sdf = std::sqrt(q * q + offset.z * offset.z) - minor_radius;
@@ -514,7 +997,7 @@ namespace alice2 {
                 }
             }
         }
-        normalize_field();
+        on_values_changed();
     }
 
     // Apply scalar plane to field
@@ -524,13 +1007,13 @@ namespace alice2 {
             for (int j = 0; j < m_res_y; ++j) {
                 for (int i = 0; i < m_res_x; ++i) {
                     const int idx = get_index(i, j, k);
-                    const Vec3& pt = m_grid_points[idx];
+                    const Vec3 pt = grid_point(i, j, k);
                     const float sdf = (pt - point).dot(norm);
                     m_field_values[idx] = sdf;
                 }
             }
         }
-        normalize_field();
+        on_values_changed();
     }
 
     // Apply scalar noise to field
@@ -539,14 +1022,265 @@ namespace alice2 {
             for (int j = 0; j < m_res_y; ++j) {
                 for (int i = 0; i < m_res_x; ++i) {
                     const int idx = get_index(i, j, k);
-                    const Vec3& pt = m_grid_points[idx];
+                    const Vec3 pt = grid_point(i, j, k);
                     // Simple noise based on position
                     float noise = std::sin(pt.x * frequency) * std::sin(pt.y * frequency) * std::sin(pt.z * frequency);
                     m_field_values[idx] = noise * amplitude;
                 }
             }
         }
-        normalize_field();
+        on_values_changed();
+    }
+
+    // Evaluate the expression row by row; each z-layer is an independent task and each row is
+    // a batched evaluation, so no intermediate fields are allocated
+    void ScalarField3D::apply_sdf(const SdfExpression& expression) {
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            std::vector<float> xs(m_res_x), ys(m_res_x), zs(m_res_x), scratch;
+            for (int j = 0; j < m_res_y; ++j) {
+                for (int i = 0; i < m_res_x; ++i) {
+                    const Vec3 pt = grid_point(i, j, k);
+                    xs[i] = pt.x;
+                    ys[i] = pt.y;
+                    zs[i] = pt.z;
+                }
+                expression.evaluate(xs.data(), ys.data(), zs.data(), m_res_x,
+                                    &m_field_values[get_index(0, j, k)], scratch);
+            }
+        });
+        on_values_changed();
+    }
+
+    // Regional variant: only grid points inside the box are evaluated and only the bricks around
+    // them are marked changed, so an incremental re-mesh afterwards touches just that region
+    void ScalarField3D::apply_sdf(const SdfExpression& expression, const Vec3& region_min, const Vec3& region_max) {
+        int lo[3] = {0, 0, 0};
+        int hi[3] = {m_res_x - 1, m_res_y - 1, m_res_z - 1};
+        if (m_custom_points.empty()) {
+            const float mins[3] = {m_min_bounds.x, m_min_bounds.y, m_min_bounds.z};
+            const float steps[3] = {m_grid_step.x, m_grid_step.y, m_grid_step.z};
+            const float region_lo[3] = {region_min.x, region_min.y, region_min.z};
+            const float region_hi[3] = {region_max.x, region_max.y, region_max.z};
+            for (int axis = 0; axis < 3; ++axis) {
+                if (steps[axis] > 0.0f) {
+                    lo[axis] = std::max(lo[axis], static_cast<int>(std::ceil((region_lo[axis] - mins[axis]) / steps[axis])));
+                    hi[axis] = std::min(hi[axis], static_cast<int>(std::floor((region_hi[axis] - mins[axis]) / steps[axis])));
+                }
+            }
+        }
+        if (lo[0] > hi[0] || lo[1] > hi[1] || lo[2] > hi[2]) return;
+
+        const int count = hi[0] - lo[0] + 1;
+        parallel_for(hi[2] - lo[2] + 1, m_extract_settings.num_threads, [&](int layer) {
+            const int k = lo[2] + layer;
+            std::vector<float> xs(count), ys(count), zs(count), out(count), scratch;
+            for (int j = lo[1]; j <= hi[1]; ++j) {
+                for (int n = 0; n < count; ++n) {
+                    const Vec3 pt = grid_point(lo[0] + n, j, k);
+                    xs[n] = pt.x;
+                    ys[n] = pt.y;
+                    zs[n] = pt.z;
+                }
+                expression.evaluate(xs.data(), ys.data(), zs.data(), count, out.data(), scratch);
+
+                float* row = &m_field_values[get_index(lo[0], j, k)];
+                for (int n = 0; n < count; ++n) {
+                    // Explicit positions are not axis aligned, so test each point against the box
+                    if (!m_custom_points.empty() &&
+                        (xs[n] < region_min.x || xs[n] > region_max.x ||
+                         ys[n] < region_min.y || ys[n] > region_max.y ||
+                         zs[n] < region_min.z || zs[n] > region_max.z)) {
+                        continue;
+                    }
+                    row[n] = out[n];
+                }
+            }
+        });
+        on_region_changed(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+    }
+
+    static float primitive_distance(const FieldPrimitive& primitive, const Vec3& p) {
+        const Vec3 d = p - primitive.center;
+        switch (primitive.shape) {
+            case PrimitiveShape::Box: {
+                const float qx = std::abs(d.x) - primitive.half_size.x;
+                const float qy = std::abs(d.y) - primitive.half_size.y;
+                const float qz = std::abs(d.z) - primitive.half_size.z;
+                const float ox = std::max(qx, 0.0f);
+                const float oy = std::max(qy, 0.0f);
+                const float oz = std::max(qz, 0.0f);
+                return std::sqrt(ox * ox + oy * oy + oz * oz) + std::min(std::max(qx, std::max(qy, qz)), 0.0f);
+            }
+            case PrimitiveShape::Torus: {
+                const float q = std::sqrt(d.x * d.x + d.y * d.y) - primitive.radius;
+                return std::sqrt(q * q + d.z * d.z) - primitive.minor_radius;
+            }
+            default:
+                return d.length() - primitive.radius;
+        }
+    }
+
+    // Bounding box of the primitive's support: the shape's box grown by the falloff margin
+    static void primitive_bounds(const FieldPrimitive& primitive, Vec3& bounds_min, Vec3& bounds_max) {
+        Vec3 extent;
+        switch (primitive.shape) {
+            case PrimitiveShape::Box:
+                extent = Vec3(std::abs(primitive.half_size.x), std::abs(primitive.half_size.y),
+                              std::abs(primitive.half_size.z));
+                break;
+            case PrimitiveShape::Torus: {
+                const float ring = std::abs(primitive.radius) + std::abs(primitive.minor_radius);
+                extent = Vec3(ring, ring, std::abs(primitive.minor_radius));
+                break;
+            }
+            default:
+                extent = Vec3(std::abs(primitive.radius), std::abs(primitive.radius), std::abs(primitive.radius));
+                break;
+        }
+        const float margin = std::max(primitive.falloff, 0.0f);
+        extent = extent + Vec3(margin, margin, margin);
+        bounds_min = primitive.center - extent;
+        bounds_max = primitive.center + extent;
+    }
+
+    static float blend_primitive(const FieldPrimitive& primitive, float value, float distance) {
+        switch (primitive.blend) {
+            case PrimitiveBlend::SmoothMin: {
+                const float k = primitive.smoothing;
+                if (k <= 0.0f) return std::min(value, distance);
+                // Same as boolean_smin, shifted by the smaller argument so large values cannot overflow
+                const float m = std::min(value, distance);
+                return m - k * std::log2(std::exp2((m - value) / k) + std::exp2((m - distance) / k));
+            }
+            case PrimitiveBlend::Add: {
+                if (distance >= primitive.falloff) return value;
+                if (distance <= 0.0f) return value + primitive.weight;
+                const float t = distance / primitive.falloff;
+                const float s = 1.0f - t * t;
+                return value + primitive.weight * s * s * s;
+            }
+            default:
+                return std::min(value, distance);
+        }
+    }
+
+    // Grid points covered by the primitive's support; false if it misses the grid. Explicit
+    // positions are not axis aligned, so then every point is a candidate.
+    bool ScalarField3D::primitive_range(const FieldPrimitive& primitive, int lo[3], int hi[3]) const {
+        lo[0] = lo[1] = lo[2] = 0;
+        hi[0] = m_res_x - 1;
+        hi[1] = m_res_y - 1;
+        hi[2] = m_res_z - 1;
+        if (m_custom_points.empty()) {
+            Vec3 bounds_min, bounds_max;
+            primitive_bounds(primitive, bounds_min, bounds_max);
+            const float mins[3] = {m_min_bounds.x, m_min_bounds.y, m_min_bounds.z};
+            const float steps[3] = {m_grid_step.x, m_grid_step.y, m_grid_step.z};
+            const float support_lo[3] = {bounds_min.x, bounds_min.y, bounds_min.z};
+            const float support_hi[3] = {bounds_max.x, bounds_max.y, bounds_max.z};
+            for (int axis = 0; axis < 3; ++axis) {
+                if (steps[axis] > 0.0f) {
+                    lo[axis] = std::max(lo[axis], static_cast<int>(std::ceil((support_lo[axis] - mins[axis]) / steps[axis])));
+                    hi[axis] = std::min(hi[axis], static_cast<int>(std::floor((support_hi[axis] - mins[axis]) / steps[axis])));
+                }
+            }
+        }
+        return lo[0] <= hi[0] && lo[1] <= hi[1] && lo[2] <= hi[2];
+    }
+
+    // Combine the primitive into grid points [lo, hi] (inclusive); no version bookkeeping
+    void ScalarField3D::splat_primitive(const FieldPrimitive& primitive, const int lo[3], const int hi[3]) {
+        Vec3 bounds_min, bounds_max;
+        primitive_bounds(primitive, bounds_min, bounds_max);
+        for (int k = lo[2]; k <= hi[2]; ++k) {
+            for (int j = lo[1]; j <= hi[1]; ++j) {
+                float* row = &m_field_values[get_index(0, j, k)];
+                for (int i = lo[0]; i <= hi[0]; ++i) {
+                    const Vec3 pt = grid_point(i, j, k);
+                    if (!m_custom_points.empty() &&
+                        (pt.x < bounds_min.x || pt.x > bounds_max.x ||
+                         pt.y < bounds_min.y || pt.y > bounds_max.y ||
+                         pt.z < bounds_min.z || pt.z > bounds_max.z)) {
+                        continue;
+                    }
+                    row[i] = blend_primitive(primitive, row[i], primitive_distance(primitive, pt));
+                }
+            }
+        }
+    }
+
+    void ScalarField3D::apply_primitive(const FieldPrimitive& primitive) {
+        int lo[3], hi[3];
+        if (!primitive_range(primitive, lo, hi)) return;
+
+        parallel_for(hi[2] - lo[2] + 1, m_extract_settings.num_threads, [&](int layer) {
+            const int layer_lo[3] = {lo[0], lo[1], lo[2] + layer};
+            const int layer_hi[3] = {hi[0], hi[1], lo[2] + layer};
+            splat_primitive(primitive, layer_lo, layer_hi);
+        });
+        on_region_changed(lo[0], lo[1], lo[2], hi[0], hi[1], hi[2]);
+    }
+
+    // Binning: every primitive is listed in each BRICK_SIZE^3 point tile its support overlaps
+    // (counting sort, so lists keep input order). Tiles own disjoint points, so they are splatted
+    // concurrently without locks and each point sees its primitives in the caller's order.
+    void ScalarField3D::apply_primitives(std::span<const FieldPrimitive> primitives) {
+        const int tiles_x = (m_res_x + BRICK_SIZE - 1) / BRICK_SIZE;
+        const int tiles_y = (m_res_y + BRICK_SIZE - 1) / BRICK_SIZE;
+        const int tiles_z = (m_res_z + BRICK_SIZE - 1) / BRICK_SIZE;
+        const size_t tile_count = static_cast<size_t>(tiles_x) * tiles_y * tiles_z;
+
+        std::vector<std::array<int, 6>> ranges(primitives.size());
+        std::vector<uint8_t> hits(primitives.size(), 0);
+        auto for_each_tile = [&](const std::array<int, 6>& range, auto&& fn) {
+            for (int tz = range[2] / BRICK_SIZE; tz <= range[5] / BRICK_SIZE; ++tz) {
+                for (int ty = range[1] / BRICK_SIZE; ty <= range[4] / BRICK_SIZE; ++ty) {
+                    for (int tx = range[0] / BRICK_SIZE; tx <= range[3] / BRICK_SIZE; ++tx) {
+                        fn((static_cast<size_t>(tz) * tiles_y + ty) * tiles_x + tx);
+                    }
+                }
+            }
+        };
+
+        std::vector<size_t> tile_start(tile_count + 1, 0);
+        for (size_t n = 0; n < primitives.size(); ++n) {
+            hits[n] = primitive_range(primitives[n], ranges[n].data(), ranges[n].data() + 3) ? 1 : 0;
+            if (hits[n]) for_each_tile(ranges[n], [&](size_t tile) { ++tile_start[tile + 1]; });
+        }
+        for (size_t tile = 0; tile < tile_count; ++tile) {
+            tile_start[tile + 1] += tile_start[tile];
+        }
+        if (tile_start[tile_count] == 0) return;
+
+        std::vector<int> tile_items(tile_start[tile_count]);
+        std::vector<size_t> cursor(tile_start.begin(), tile_start.end() - 1);
+        for (size_t n = 0; n < primitives.size(); ++n) {
+            if (hits[n]) for_each_tile(ranges[n], [&](size_t tile) { tile_items[cursor[tile]++] = static_cast<int>(n); });
+        }
+
+        std::vector<int> active_tiles;
+        for (size_t tile = 0; tile < tile_count; ++tile) {
+            if (tile_start[tile + 1] > tile_start[tile]) active_tiles.push_back(static_cast<int>(tile));
+        }
+
+        parallel_for(static_cast<int>(active_tiles.size()), m_extract_settings.num_threads, [&](int a) {
+            const int tile = active_tiles[a];
+            const int tile_coords[3] = {tile % tiles_x, (tile / tiles_x) % tiles_y, tile / (tiles_x * tiles_y)};
+            const int res[3] = {m_res_x, m_res_y, m_res_z};
+            for (size_t item = tile_start[tile]; item < tile_start[tile + 1]; ++item) {
+                const std::array<int, 6>& range = ranges[tile_items[item]];
+                int lo[3], hi[3];
+                for (int axis = 0; axis < 3; ++axis) {
+                    lo[axis] = std::max(range[axis], tile_coords[axis] * BRICK_SIZE);
+                    hi[axis] = std::min({range[axis + 3], tile_coords[axis] * BRICK_SIZE + BRICK_SIZE - 1, res[axis] - 1});
+                }
+                splat_primitive(primitives[tile_items[item]], lo, hi);
+            }
+        });
+
+        for (size_t n = 0; n < primitives.size(); ++n) {
+            if (hits[n]) on_region_changed(ranges[n][0], ranges[n][1], ranges[n][2], ranges[n][3], ranges[n][4], ranges[n][5]);
+        }
     }
 
     // Boolean operations - simplified versions
@@ -558,7 +1292,7 @@ namespace alice2 {
         for (size_t i = 0; i < m_field_values.size(); ++i) {
             m_field_values[i] = std::min(m_field_values[i], other.m_field_values[i]);
         }
-        normalize_field();
+        on_values_changed();
     }
 
     void ScalarField3D::boolean_intersect(const ScalarField3D& other) {
@@ -569,7 +1303,7 @@ namespace alice2 {
         for (size_t i = 0; i < m_field_values.size(); ++i) {
             m_field_values[i] = std::max(m_field_values[i], other.m_field_values[i]);
         }
-        normalize_field();
+        on_values_changed();
     }
 
     void ScalarField3D::boolean_subtract(const ScalarField3D& other) {
@@ -580,7 +1314,7 @@ namespace alice2 {
         for (size_t i = 0; i < m_field_values.size(); ++i) {
             m_field_values[i] = std::max(m_field_values[i], -other.m_field_values[i]);
         }
-        normalize_field();
+        on_values_changed();
     }
 
     void ScalarField3D::boolean_smin(const ScalarField3D& other, float smoothing) {
@@ -594,11 +1328,280 @@ namespace alice2 {
             float r = std::exp2(-a / smoothing) + std::exp2(-b / smoothing);
             m_field_values[i] = -smoothing * std::log2(r);
         }
-        normalize_field();
+        on_values_changed();
+    }
+
+    // Redistancing works on 8^3 point tiles. Tiles are coloured by the parity of their tile
+    // coordinates: the upwind stencil only reaches face neighbours, so tiles of one colour never
+    // read each other's points and can be swept concurrently without changing the result.
+    static constexpr int REDISTANCE_TILE = 8;
+
+    struct RedistanceGrid {
+        int res[3];
+        float h[3];
+        float inv_h2[3];
+        float cutoff;               // distances beyond this are not propagated (narrow band)
+        float* dist;                // unsigned distance, infinity until reached
+        const uint8_t* frozen;      // interface points seeded from the original crossings
+
+        // Godunov upwind solve of |grad d| = 1 at one point from its axis neighbours
+        float solve(int i, int j, int k) const {
+            const int coords[3] = {i, j, k};
+            const int strides[3] = {1, res[0], res[0] * res[1]};
+            const int idx = i + j * strides[1] + k * strides[2];
+
+            float a[3];
+            float w[3];
+            int n = 0;
+            for (int axis = 0; axis < 3; ++axis) {
+                float lo = std::numeric_limits<float>::infinity();
+                if (coords[axis] > 0) lo = std::min(lo, dist[idx - strides[axis]]);
+                if (coords[axis] + 1 < res[axis]) lo = std::min(lo, dist[idx + strides[axis]]);
+                if (lo == std::numeric_limits<float>::infinity()) continue;
+
+                // keep neighbour values sorted ascending
+                int slot = n++;
+                while (slot > 0 && a[slot - 1] > lo) {
+                    a[slot] = a[slot - 1];
+                    w[slot] = w[slot - 1];
+                    --slot;
+                }
+                a[slot] = lo;
+                w[slot] = inv_h2[axis];
+            }
+            if (n == 0) return std::numeric_limits<float>::infinity();
+
+            // Add axes while the solution still exceeds the next neighbour value
+            float u = a[0] + 1.0f / std::sqrt(w[0]);
+            float sum_w = w[0], sum_wa = w[0] * a[0], sum_wa2 = w[0] * a[0] * a[0];
+            for (int m = 1; m < n && u > a[m]; ++m) {
+                sum_w += w[m];
+                sum_wa += w[m] * a[m];
+                sum_wa2 += w[m] * a[m] * a[m];
+                const float disc = sum_wa * sum_wa - sum_w * (sum_wa2 - 1.0f);
+                if (disc < 0.0f) break;
+                u = (sum_wa + std::sqrt(disc)) / sum_w;
+            }
+            return u;
+        }
+
+        // Gauss-Seidel sweeps over one tile in all eight axis orderings; returns the largest change
+        float sweep_tile(int tx, int ty, int tz) const {
+            const int lo[3] = {tx * REDISTANCE_TILE, ty * REDISTANCE_TILE, tz * REDISTANCE_TILE};
+            const int hi[3] = {std::min(res[0], lo[0] + REDISTANCE_TILE) - 1,
+                               std::min(res[1], lo[1] + REDISTANCE_TILE) - 1,
+                               std::min(res[2], lo[2] + REDISTANCE_TILE) - 1};
+
+            float max_change = 0.0f;
+            for (int dir = 0; dir < 8; ++dir) {
+                const int sx = (dir & 1) ? -1 : 1;
+                const int sy = (dir & 2) ? -1 : 1;
+                const int sz = (dir & 4) ? -1 : 1;
+                for (int k = sz > 0 ? lo[2] : hi[2]; k >= lo[2] && k <= hi[2]; k += sz) {
+                    for (int j = sy > 0 ? lo[1] : hi[1]; j >= lo[1] && j <= hi[1]; j += sy) {
+                        for (int i = sx > 0 ? lo[0] : hi[0]; i >= lo[0] && i <= hi[0]; i += sx) {
+                            const int idx = i + (j + k * res[1]) * res[0];
+                            if (frozen[idx]) continue;
+                            const float u = solve(i, j, k);
+                            if (u < dist[idx] && u <= cutoff) {
+                                const float old = dist[idx];
+                                dist[idx] = u;
+                                max_change = std::max(max_change, old == std::numeric_limits<float>::infinity()
+                                                                      ? std::numeric_limits<float>::max() : old - u);
+                            }
+                        }
+                    }
+                }
+            }
+            return max_change;
+        }
+    };
+
+    // Fast sweeping reinitialization of the zero level set:
+    // 1. points next to a sign change get their distance from the linearly interpolated crossings
+    //    along each axis and stay frozen,
+    // 2. the remaining points of the active tiles are swept by colour until the largest update
+    //    drops below a small fraction of a cell,
+    // 3. the original signs are reapplied; with a band, magnitudes are clamped to band_width.
+    void ScalarField3D::redistance(float band_width, int max_iterations) {
+        if (m_field_values.empty()) {
+            return;
+        }
+
+        const Vec3 step = get_cell_size();
+        RedistanceGrid grid;
+        grid.res[0] = m_res_x;
+        grid.res[1] = m_res_y;
+        grid.res[2] = m_res_z;
+        grid.h[0] = step.x > 0.0f ? step.x : 1.0f;
+        grid.h[1] = step.y > 0.0f ? step.y : 1.0f;
+        grid.h[2] = step.z > 0.0f ? step.z : 1.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            grid.inv_h2[axis] = 1.0f / (grid.h[axis] * grid.h[axis]);
+        }
+
+        const size_t count = m_field_values.size();
+        std::vector<float> dist(count, std::numeric_limits<float>::infinity());
+        std::vector<uint8_t> frozen(count, 0);
+        grid.dist = dist.data();
+        grid.frozen = frozen.data();
+
+        const int tiles[3] = {(m_res_x + REDISTANCE_TILE - 1) / REDISTANCE_TILE,
+                              (m_res_y + REDISTANCE_TILE - 1) / REDISTANCE_TILE,
+                              (m_res_z + REDISTANCE_TILE - 1) / REDISTANCE_TILE};
+        const int tile_total = tiles[0] * tiles[1] * tiles[2];
+        std::vector<uint8_t> interface_tile(tile_total, 0);
+
+        // Seed the interface, one z-layer per task
+        const int strides[3] = {1, m_res_x, m_res_x * m_res_y};
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            for (int j = 0; j < m_res_y; ++j) {
+                for (int i = 0; i < m_res_x; ++i) {
+                    const int coords[3] = {i, j, k};
+                    const int idx = get_index(i, j, k);
+                    const float value = m_field_values[idx];
+                    const bool inside = value < 0.0f;
+
+                    float inv_d2 = 0.0f;
+                    bool crossing = false;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        float d = std::numeric_limits<float>::infinity();
+                        for (int side = -1; side <= 1; side += 2) {
+                            const int c = coords[axis] + side;
+                            if (c < 0 || c >= grid.res[axis]) continue;
+                            const float other = m_field_values[idx + side * strides[axis]];
+                            if ((other < 0.0f) == inside) continue;
+                            d = std::min(d, value / (value - other) * grid.h[axis]);
+                        }
+                        if (d == std::numeric_limits<float>::infinity()) continue;
+                        crossing = true;
+                        if (d <= 0.0f) {
+                            inv_d2 = std::numeric_limits<float>::infinity();
+                        } else {
+                            inv_d2 += 1.0f / (d * d);
+                        }
+                    }
+
+                    if (crossing) {
+                        dist[idx] = 1.0f / std::sqrt(inv_d2);
+                        frozen[idx] = 1;
+                    }
+                }
+            }
+        });
+
+        bool any_interface = false;
+        for (int k = 0; k < m_res_z; ++k) {
+            for (int j = 0; j < m_res_y; ++j) {
+                for (int i = 0; i < m_res_x; ++i) {
+                    if (frozen[get_index(i, j, k)]) {
+                        interface_tile[(k / REDISTANCE_TILE * tiles[1] + j / REDISTANCE_TILE) * tiles[0] + i / REDISTANCE_TILE] = 1;
+                        any_interface = true;
+                    }
+                }
+            }
+        }
+        if (!any_interface) {
+            return;     // no zero crossing to measure distances from
+        }
+
+        // Active tiles: everything, or the interface tiles dilated far enough to cover the band
+        const bool banded = band_width > 0.0f;
+        grid.cutoff = banded ? band_width + std::max({grid.h[0], grid.h[1], grid.h[2]})
+                             : std::numeric_limits<float>::infinity();
+        std::vector<uint8_t> active_tile(tile_total, banded ? 0 : 1);
+        if (banded) {
+            int reach[3];
+            for (int axis = 0; axis < 3; ++axis) {
+                reach[axis] = static_cast<int>(std::ceil(band_width / (grid.h[axis] * REDISTANCE_TILE)));
+            }
+            for (int tz = 0; tz < tiles[2]; ++tz) {
+                for (int ty = 0; ty < tiles[1]; ++ty) {
+                    for (int tx = 0; tx < tiles[0]; ++tx) {
+                        if (!interface_tile[(tz * tiles[1] + ty) * tiles[0] + tx]) continue;
+                        for (int z = std::max(0, tz - reach[2]); z <= std::min(tiles[2] - 1, tz + reach[2]); ++z) {
+                            for (int y = std::max(0, ty - reach[1]); y <= std::min(tiles[1] - 1, ty + reach[1]); ++y) {
+                                for (int x = std::max(0, tx - reach[0]); x <= std::min(tiles[0] - 1, tx + reach[0]); ++x) {
+                                    active_tile[(z * tiles[1] + y) * tiles[0] + x] = 1;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<int> colour_tiles[8];
+        for (int tz = 0; tz < tiles[2]; ++tz) {
+            for (int ty = 0; ty < tiles[1]; ++ty) {
+                for (int tx = 0; tx < tiles[0]; ++tx) {
+                    const int tile = (tz * tiles[1] + ty) * tiles[0] + tx;
+                    if (active_tile[tile]) {
+                        colour_tiles[(tx & 1) | ((ty & 1) << 1) | ((tz & 1) << 2)].push_back(tile);
+                    }
+                }
+            }
+        }
+
+        // Sweep until no tile is pending. A tile converges against its current boundary in one
+        // sweep, so it only needs another pass when a face neighbour changed by more than the
+        // tolerance; alternating the colour order lets information cross tiles both ways.
+        const float tolerance = 1e-3f * std::min({grid.h[0], grid.h[1], grid.h[2]});
+        std::vector<uint8_t> pending(active_tile);
+        std::vector<float> tile_change(tile_total, 0.0f);
+        std::vector<int> batch;
+        for (int iteration = 0; iteration < max_iterations; ++iteration) {
+            bool swept = false;
+            for (int c = 0; c < 8; ++c) {
+                batch.clear();
+                for (int tile : colour_tiles[(iteration & 1) ? 7 - c : c]) {
+                    if (pending[tile]) {
+                        pending[tile] = 0;
+                        batch.push_back(tile);
+                    }
+                }
+                if (batch.empty()) continue;
+                swept = true;
+
+                parallel_for(static_cast<int>(batch.size()), m_extract_settings.num_threads, [&](int n) {
+                    const int tile = batch[n];
+                    const int tx = tile % tiles[0];
+                    const int ty = (tile / tiles[0]) % tiles[1];
+                    const int tz = tile / (tiles[0] * tiles[1]);
+                    tile_change[tile] = grid.sweep_tile(tx, ty, tz);
+                });
+
+                for (int tile : batch) {
+                    if (tile_change[tile] <= tolerance) continue;
+                    const int t[3] = {tile % tiles[0], (tile / tiles[0]) % tiles[1], tile / (tiles[0] * tiles[1])};
+                    const int tile_strides[3] = {1, tiles[0], tiles[0] * tiles[1]};
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (t[axis] > 0) pending[tile - tile_strides[axis]] = active_tile[tile - tile_strides[axis]];
+                        if (t[axis] + 1 < tiles[axis]) pending[tile + tile_strides[axis]] = active_tile[tile + tile_strides[axis]];
+                    }
+                }
+            }
+            if (!swept) {
+                break;
+            }
+        }
+
+        // Reapply the signs; points outside the active tiles keep the band value
+        const float limit = banded ? band_width : std::numeric_limits<float>::max();
+        parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+            for (int j = 0; j < m_res_y; ++j) {
+                for (int i = 0; i < m_res_x; ++i) {
+                    const int idx = get_index(i, j, k);
+                    const float magnitude = std::min(dist[idx], limit);
+                    m_field_values[idx] = m_field_values[idx] < 0.0f ? -magnitude : magnitude;
+                }
+            }
+        });
+        on_values_changed();
     }
 
     // Vertex classification for extended marching cubes
-    alice2::VertexClass ScalarField3D::classify_vertex(float value, float isolevel, float tolerance) const {
+    alice2::VertexClass ScalarField3D::classify_vertex(float value, float isolevel, float tolerance) {
         float diff = value - isolevel;
         if (std::abs(diff) <= tolerance) {
             return alice2::VertexClass::ZERO;
@@ -607,12 +1610,12 @@ namespace alice2 {
     }
 
     // Original vertex interpolation for marching cubes (kept for compatibility)
-    Vec3 ScalarField3D::vertex_interpolate(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2) const {
+    Vec3 ScalarField3D::vertex_interpolate(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2) {
         return vertex_interpolate_robust(isolevel, p1, p2, val1, val2);
     }
 
     // Robust vertex interpolation for marching cubes with better numerical stability
-    Vec3 ScalarField3D::vertex_interpolate_robust(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2) const {
+    Vec3 ScalarField3D::vertex_interpolate_robust(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2) {
         const float tolerance = 1e-6f;
 
         // Check if isolevel is very close to either vertex value
@@ -649,14 +1652,14 @@ namespace alice2 {
         }
 
         // Define the 8 vertices of the cube in standard marching cubes order
-        cell.vertices[0] = cell_position(x, y, z);
-        cell.vertices[1] = cell_position(x + 1, y, z);
-        cell.vertices[2] = cell_position(x + 1, y + 1, z);
-        cell.vertices[3] = cell_position(x, y + 1, z);
-        cell.vertices[4] = cell_position(x, y, z + 1);
-        cell.vertices[5] = cell_position(x + 1, y, z + 1);
-        cell.vertices[6] = cell_position(x + 1, y + 1, z + 1);
-        cell.vertices[7] = cell_position(x, y + 1, z + 1);
+        cell.vertices[0] = grid_point(x, y, z);
+        cell.vertices[1] = grid_point(x + 1, y, z);
+        cell.vertices[2] = grid_point(x + 1, y + 1, z);
+        cell.vertices[3] = grid_point(x, y + 1, z);
+        cell.vertices[4] = grid_point(x, y, z + 1);
+        cell.vertices[5] = grid_point(x + 1, y, z + 1);
+        cell.vertices[6] = grid_point(x + 1, y + 1, z + 1);
+        cell.vertices[7] = grid_point(x, y + 1, z + 1);
 
         // Get scalar values at each vertex
         cell.values[0] = m_field_values[get_index(x, y, z)];
@@ -677,7 +1680,7 @@ namespace alice2 {
     }
 
     // Check if a triangle is degenerate (has zero or near-zero area)
-    bool ScalarField3D::is_triangle_degenerate(const MCTriangle& triangle, float tolerance) const {
+    bool ScalarField3D::is_triangle_degenerate(const MCTriangle& triangle, float tolerance) {
         Vec3 v1 = triangle.vertices[1] - triangle.vertices[0];
         Vec3 v2 = triangle.vertices[2] - triangle.vertices[0];
         Vec3 cross = v1.cross(v2);
@@ -685,7 +1688,7 @@ namespace alice2 {
     }
 
     // Validate triangle quality (area and aspect ratio)
-    bool ScalarField3D::validate_triangle_quality(const MCTriangle& triangle, float min_area) const {
+    bool ScalarField3D::validate_triangle_quality(const MCTriangle& triangle, float min_area) {
         Vec3 v1 = triangle.vertices[1] - triangle.vertices[0];
         Vec3 v2 = triangle.vertices[2] - triangle.vertices[0];
         Vec3 v3 = triangle.vertices[2] - triangle.vertices[1];
@@ -716,43 +1719,144 @@ namespace alice2 {
         return true;
     }
 
-    // Extract triangles using proper marching cubes algorithm
-    std::vector<MCTriangle> ScalarField3D::extract_triangles(float isolevel) const {
-        std::vector<MCTriangle> triangles;
-        int processed_cells = 0;
+    // Polygonize the cells in z-layers [z_begin, z_end), appending in k, j, i order.
+    // Cells of bricks that cannot contain the isolevel are skipped without being visited;
+    // they produce no triangles, so the output is the same as a dense sweep.
+    // Returns the number of cells that produced triangles.
+    int ScalarField3D::extract_slab(float isolevel, int z_begin, int z_end, const MCBrickMask& mask,
+                                    std::vector<MCTriangle>& triangles) const {
+        int offsets[8];
+        cell_corner_offsets(offsets);
         int active_cells = 0;
+        for (int k = z_begin; k < z_end; ++k) {
+            const int bz = k / BRICK_SIZE;
+            if (!mask.layers[bz]) {
+                k = (bz + 1) * BRICK_SIZE - 1;
+                continue;
+            }
 
-        // Process each cell in the grid
-        for (int k = 0; k < m_res_z - 1; ++k) {
             for (int j = 0; j < m_res_y - 1; ++j) {
-                for (int i = 0; i < m_res_x - 1; ++i) {
-                    GridCell cell = get_grid_cell(i, j, k);
-                    int triangles_before = static_cast<int>(triangles.size());
-                    polygonize_cell(cell, isolevel, triangles);
-                    // polygonize_cell_tetra(cell, isolevel, triangles);
-                    int triangles_after = static_cast<int>(triangles.size());
-
-                    processed_cells++;
-                    if (triangles_after > triangles_before) {
-                        active_cells++;
-                    }
+                const int by = j / BRICK_SIZE;
+                const size_t row = static_cast<size_t>(bz) * mask.bricks_y + by;
+                if (!mask.rows[row]) {
+                    j = (by + 1) * BRICK_SIZE - 1;
+                    continue;
                 }
-            }
-        }
 
-        std::cout << "Enhanced Marching Cubes processed " << processed_cells << " cells, "
-                  << active_cells << " generated triangles, total triangles: "
-                  << triangles.size() << std::endl;
+                for (int bx = 0; bx < mask.bricks_x; ++bx) {
+                    if (!mask.bricks[row * mask.bricks_x + bx]) continue;
+
+                    const int i_begin = bx * BRICK_SIZE;
+                    const int i_end = std::min(m_res_x - 1, (bx + 1) * BRICK_SIZE);
+                    if (m_extract_settings.legacy_kernel) {
+                        for (int i = i_begin; i < i_end; ++i) {
+                            GridCell cell = get_grid_cell(i, j, k);
+                            if (polygonize_cell(cell, isolevel, triangles) > 0) {
+                                active_cells++;
+                            }
+                            // polygonize_cell_tetra(cell, isolevel, triangles);
+                        }
+                        continue;
+                    }
 
-        return triangles;
+                    // Classify the segment's points once per row (neighbouring cells share four
+                    // corners), size the output for the listed triangles, then fill it in place
+                    const int rows[4] = {get_index(0, j, k), get_index(0, j + 1, k),
+                                         get_index(0, j, k + 1), get_index(0, j + 1, k + 1)};
+                    unsigned char above[4][BRICK_SIZE + 1];
+                    for (int r = 0; r < 4; ++r) {
+                        for (int i = i_begin; i <= i_end; ++i) {
+                            above[r][i - i_begin] = (m_field_values[rows[r] + i] - isolevel) >= -1e-6f;
+                        }
+                    }
+
+                    int listed = 0;
+                    for (int x = 0; x < i_end - i_begin; ++x) {
+                        const int cube = above[0][x] | (above[0][x + 1] << 1) | (above[1][x + 1] << 2) | (above[1][x] << 3) |
+                                         (above[2][x] << 4) | (above[2][x + 1] << 5) | (above[3][x + 1] << 6) | (above[3][x] << 7);
+                        listed += MC_CASES.triangle_count[cube];
+                    }
+                    if (listed == 0) continue;
+
+                    size_t cursor = triangles.size();
+                    triangles.resize(cursor + listed);
+                    for (int i = i_begin; i < i_end; ++i) {
+                        const int written = polygonize_cell_strided(offsets, i, j, k, isolevel, triangles.data() + cursor);
+                        if (written > 0) {
+                            cursor += written;
+                            active_cells++;
+                        }
+                    }
+                    triangles.resize(cursor);
+                }
+            }
+        }
+        return active_cells;
     }
 
-    // Generate mesh data from scalar field
-    std::shared_ptr<MeshData> ScalarField3D::generate_mesh(float isolevel) const {
+    // Extract triangles using proper marching cubes algorithm.
+    // The grid is split into z-slabs that are polygonized independently, each into its own
+    // buffer; with deterministic merging the buffers are concatenated in slab order, which
+    // reproduces the serial cell order exactly.
+    std::vector<MCTriangle> ScalarField3D::extract_triangles(float isolevel) const {
+        std::vector<MCTriangle> triangles;
+        const int cell_layers = m_res_z - 1;
+        if (m_res_x < 2 || m_res_y < 2 || cell_layers < 1) {
+            return triangles;
+        }
+
+        MCBrickMask mask;
+        build_brick_mask(isolevel, mask);
+
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        // A few slabs per thread keeps the load balanced when the surface is unevenly distributed;
+        // slabs are whole brick layers so skipping never straddles a slab boundary
+        const int slab_count = std::min(mask.bricks_z, num_threads == 1 ? 1 : num_threads * 4);
+        const int slab_depth = ((mask.bricks_z + slab_count - 1) / slab_count) * BRICK_SIZE;
+
+        std::vector<std::vector<MCTriangle>> slab_triangles;
+        if (m_extract_settings.deterministic) {
+            slab_triangles.resize(slab_count);
+        }
+        std::mutex merge_mutex;
+
+        parallel_for(slab_count, num_threads, [&](int slab) {
+            const int z_begin = slab * slab_depth;
+            const int z_end = std::min(cell_layers, z_begin + slab_depth);
+            if (z_begin >= z_end) {
+                return;
+            }
+
+            if (m_extract_settings.deterministic) {
+                extract_slab(isolevel, z_begin, z_end, mask, slab_triangles[slab]);
+                return;
+            }
+
+            // Unordered merge: append as soon as the slab is done
+            std::vector<MCTriangle> local;
+            extract_slab(isolevel, z_begin, z_end, mask, local);
+            std::lock_guard<std::mutex> lock(merge_mutex);
+            triangles.insert(triangles.end(), local.begin(), local.end());
+        });
+
+        if (m_extract_settings.deterministic) {
+            size_t total = 0;
+            for (const auto& slab : slab_triangles) {
+                total += slab.size();
+            }
+            triangles.reserve(total);
+            for (const auto& slab : slab_triangles) {
+                triangles.insert(triangles.end(), slab.begin(), slab.end());
+            }
+        }
+
+        return triangles;
+    }
+
+    // Convert a triangle soup to mesh data: three vertices and three edges per triangle
+    static std::shared_ptr<MeshData> triangles_to_mesh(const std::vector<MCTriangle>& triangles) {
         auto meshData = std::make_shared<MeshData>();
-        std::vector<MCTriangle> triangles = extract_triangles(isolevel);
 
-        // Convert triangles to mesh data
         for (const auto& triangle : triangles) {
             int baseIndex = static_cast<int>(meshData->vertices.size());
 
@@ -760,7 +1864,9 @@ namespace alice2 {
             for (int i = 0; i < 3; ++i) {
                 MeshVertex vertex;
                 vertex.position = triangle.vertices[i];
-                vertex.normal = triangle.normal;
+                const Vec3& smooth = triangle.vertex_normals[i];
+                const bool has_smooth = smooth.x != 0.0f || smooth.y != 0.0f || smooth.z != 0.0f;
+                vertex.normal = has_smooth ? smooth : triangle.normal;
                 vertex.color = Color(0.8f, 0.8f, 0.9f); // Light blue-gray
                 meshData->vertices.push_back(vertex);
             }
@@ -782,8 +1888,1199 @@ namespace alice2 {
         return meshData;
     }
 
+    // Generate mesh data from scalar field
+    std::shared_ptr<MeshData> ScalarField3D::generate_mesh(float isolevel) const {
+        return triangles_to_mesh(extract_triangles(isolevel));
+    }
+
+    // Multi-level counterpart of extract_slab. Each cell is gathered once; its value range picks
+    // the run of levels that cross it and only those are polygonized.
+    void ScalarField3D::extract_slab_multi(std::span<const float> sorted_isolevels, int z_begin, int z_end,
+                                           const MCBrickMask& mask, std::vector<std::vector<MCTriangle>>& triangles) const {
+        triangles.resize(sorted_isolevels.size());
+        int offsets[8];
+        cell_corner_offsets(offsets);
+        for (int k = z_begin; k < z_end; ++k) {
+            const int bz = k / BRICK_SIZE;
+            if (!mask.layers[bz]) {
+                k = (bz + 1) * BRICK_SIZE - 1;
+                continue;
+            }
+
+            for (int j = 0; j < m_res_y - 1; ++j) {
+                const int by = j / BRICK_SIZE;
+                const size_t row = static_cast<size_t>(bz) * mask.bricks_y + by;
+                if (!mask.rows[row]) {
+                    j = (by + 1) * BRICK_SIZE - 1;
+                    continue;
+                }
+
+                for (int bx = 0; bx < mask.bricks_x; ++bx) {
+                    if (!mask.bricks[row * mask.bricks_x + bx]) continue;
+
+                    const int i_begin = bx * BRICK_SIZE;
+                    const int i_end = std::min(m_res_x - 1, (bx + 1) * BRICK_SIZE);
+                    if (m_extract_settings.legacy_kernel) {
+                        for (int i = i_begin; i < i_end; ++i) {
+                            GridCell cell = get_grid_cell(i, j, k);
+                            const auto [min_it, max_it] = std::minmax_element(cell.values, cell.values + 8);
+                            const auto [first, last] = crossing_levels(sorted_isolevels, *min_it, *max_it);
+                            for (size_t level = first; level < last; ++level) {
+                                polygonize_cell(cell, sorted_isolevels[level], triangles[level]);
+                            }
+                        }
+                        continue;
+                    }
+
+                    // Gather the segment's corner values and crossing levels once, then per level
+                    // size the output for the listed triangles and fill it in place, as extract_slab does
+                    float values[BRICK_SIZE][8];
+                    std::pair<size_t, size_t> levels[BRICK_SIZE];
+                    size_t segment_first = sorted_isolevels.size();
+                    size_t segment_last = 0;
+                    for (int x = 0; x < i_end - i_begin; ++x) {
+                        const int base = get_index(i_begin + x, j, k);
+                        for (int c = 0; c < 8; ++c) {
+                            values[x][c] = m_field_values[base + offsets[c]];
+                        }
+                        const auto [min_it, max_it] = std::minmax_element(values[x], values[x] + 8);
+                        levels[x] = crossing_levels(sorted_isolevels, *min_it, *max_it);
+                        if (levels[x].first < levels[x].second) {
+                            segment_first = std::min(segment_first, levels[x].first);
+                            segment_last = std::max(segment_last, levels[x].second);
+                        }
+                    }
+
+                    for (size_t level = segment_first; level < segment_last; ++level) {
+                        const float isolevel = sorted_isolevels[level];
+                        int listed = 0;
+                        for (int x = 0; x < i_end - i_begin; ++x) {
+                            if (level < levels[x].first || level >= levels[x].second) continue;
+                            int cube = 0;
+                            for (int c = 0; c < 8; ++c) {
+                                if (values[x][c] - isolevel >= -1e-6f) cube |= 1 << c;
+                            }
+                            listed += MC_CASES.triangle_count[cube];
+                        }
+                        if (listed == 0) continue;
+
+                        std::vector<MCTriangle>& out = triangles[level];
+                        size_t cursor = out.size();
+                        out.resize(cursor + listed);
+                        for (int x = 0; x < i_end - i_begin; ++x) {
+                            if (level < levels[x].first || level >= levels[x].second) continue;
+                            cursor += polygonize_cell_strided(offsets, i_begin + x, j, k, isolevel, out.data() + cursor);
+                        }
+                        out.resize(cursor);
+                    }
+                }
+            }
+        }
+    }
+
+    // Extract the surfaces of several isolevels in a single pass over the grid. Levels are
+    // sorted internally so every cell and brick can select its crossing levels by binary search;
+    // each level's triangles come out in the same order extract_triangles would produce them.
+    std::vector<std::vector<MCTriangle>> ScalarField3D::extract_triangles_multi(std::span<const float> isolevels) const {
+        std::vector<std::vector<MCTriangle>> result(isolevels.size());
+        const int cell_layers = m_res_z - 1;
+        if (isolevels.empty() || m_res_x < 2 || m_res_y < 2 || cell_layers < 1) {
+            return result;
+        }
+
+        std::vector<size_t> order(isolevels.size());
+        for (size_t n = 0; n < order.size(); ++n) {
+            order[n] = n;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return isolevels[a] < isolevels[b]; });
+        std::vector<float> sorted(isolevels.size());
+        for (size_t n = 0; n < order.size(); ++n) {
+            sorted[n] = isolevels[order[n]];
+        }
+
+        MCBrickMask mask;
+        build_brick_mask(sorted, mask);
+
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        const int slab_count = std::min(mask.bricks_z, num_threads == 1 ? 1 : num_threads * 4);
+        const int slab_depth = ((mask.bricks_z + slab_count - 1) / slab_count) * BRICK_SIZE;
+
+        std::vector<std::vector<std::vector<MCTriangle>>> slab_triangles(slab_count);
+        parallel_for(slab_count, num_threads, [&](int slab) {
+            const int z_begin = slab * slab_depth;
+            const int z_end = std::min(cell_layers, z_begin + slab_depth);
+            if (z_begin < z_end) {
+                extract_slab_multi(sorted, z_begin, z_end, mask, slab_triangles[slab]);
+            }
+        });
+
+        for (size_t level = 0; level < sorted.size(); ++level) {
+            std::vector<MCTriangle>& triangles = result[order[level]];
+            for (auto& slab : slab_triangles) {
+                if (level < slab.size()) {
+                    triangles.insert(triangles.end(), slab[level].begin(), slab[level].end());
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<std::shared_ptr<MeshData>> ScalarField3D::generate_mesh_multi(std::span<const float> isolevels) const {
+        std::vector<std::shared_ptr<MeshData>> meshes;
+        meshes.reserve(isolevels.size());
+        for (const auto& triangles : extract_triangles_multi(isolevels)) {
+            meshes.push_back(triangles_to_mesh(triangles));
+        }
+        return meshes;
+    }
+
+    // Indexed marching cubes over cell layers [z_begin, z_end). Each grid edge crossing becomes
+    // one vertex: x/y-edge vertices are cached for the lower and upper layer of the current cell
+    // layer and z-edge vertices for the layer in between, so the caches roll up through the slab.
+    // Empty bricks are skipped; after a skipped brick layer the lower cache is stale and is reset.
+    void ScalarField3D::extract_indexed_slab(float isolevel, int z_begin, int z_end, const MCBrickMask& mask,
+                                             MCMeshSlab& slab) const {
+        const int plane = m_res_x * m_res_y;
+        std::vector<int> lower(2 * plane, -1);
+        std::vector<int> upper(2 * plane, -1);
+        std::vector<int> vertical(plane, -1);
+        std::vector<int>* caches[3] = {&lower, &upper, &vertical};
+        bool lower_stale = false;
+        slab.owned_boundary.assign(2 * plane, -1);
+
+        for (int k = z_begin; k < z_end; ++k) {
+            const int bz = k / BRICK_SIZE;
+            if (!mask.layers[bz]) {
+                k = (bz + 1) * BRICK_SIZE - 1;
+                lower_stale = true;
+                continue;
+            }
+            if (lower_stale) {
+                std::fill(lower.begin(), lower.end(), -1);
+                lower_stale = false;
+            }
+            std::fill(upper.begin(), upper.end(), -1);
+            std::fill(vertical.begin(), vertical.end(), -1);
+
+            for (int j = 0; j < m_res_y - 1; ++j) {
+                const int by = j / BRICK_SIZE;
+                const size_t row = static_cast<size_t>(bz) * mask.bricks_y + by;
+                if (!mask.rows[row]) {
+                    j = (by + 1) * BRICK_SIZE - 1;
+                    continue;
+                }
+
+                for (int bx = 0; bx < mask.bricks_x; ++bx) {
+                    if (!mask.bricks[row * mask.bricks_x + bx]) continue;
+
+                    const int i_end = std::min(m_res_x - 1, (bx + 1) * BRICK_SIZE);
+                    for (int i = bx * BRICK_SIZE; i < i_end; ++i) {
+                        int corner_index[8];
+                        float values[8];
+                        int cubeindex = 0;
+                        for (int c = 0; c < 8; ++c) {
+                            corner_index[c] = get_index(i + MC_CORNER_OFFSETS[c][0],
+                                                        j + MC_CORNER_OFFSETS[c][1],
+                                                        k + MC_CORNER_OFFSETS[c][2]);
+                            values[c] = m_field_values[corner_index[c]];
+                            if (classify_vertex(values[c], isolevel) != alice2::VertexClass::NEGATIVE) {
+                                cubeindex |= 1 << c;
+                            }
+                        }
+
+                        const int edges = EDGE_TABLE[cubeindex];
+                        if (edges == 0) continue;
+
+                        auto corner_point = [&](int c) {
+                            return grid_point(i + MC_CORNER_OFFSETS[c][0],
+                                              j + MC_CORNER_OFFSETS[c][1],
+                                              k + MC_CORNER_OFFSETS[c][2]);
+                        };
+
+                        // Look up or create the vertex of every intersected edge
+                        int edge_vertex[12];
+                        for (int e = 0; e < 12; ++e) {
+                            if (!(edges & (1 << e))) continue;
+
+                            const MCEdgeRef& ref = MC_EDGE_REFS[e];
+                            const int slot = ref.axis * plane + (j + ref.dj) * m_res_x + (i + ref.di);
+                            int& cached = (*caches[ref.cache])[slot];
+                            if (cached < 0) {
+                                const int a = ref.corner_a;
+                                const int b = ref.corner_b;
+                                cached = static_cast<int>(slab.positions.size());
+                                slab.positions.push_back(vertex_interpolate_robust(isolevel,
+                                    corner_point(a), corner_point(b),
+                                    values[a], values[b]));
+                            }
+                            edge_vertex[e] = cached;
+                        }
+
+                        for (int t = 0; t < 16 && TRI_TABLE[cubeindex][t] != -1; t += 3) {
+                            const int v0 = edge_vertex[TRI_TABLE[cubeindex][t]];
+                            const int v1 = edge_vertex[TRI_TABLE[cubeindex][t + 1]];
+                            const int v2 = edge_vertex[TRI_TABLE[cubeindex][t + 2]];
+                            // Zero-area triangles between distinct vertices are kept so the surface stays closed
+                            if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+
+                            slab.indices.push_back(v0);
+                            slab.indices.push_back(v1);
+                            slab.indices.push_back(v2);
+                        }
+                    }
+                }
+            }
+
+            if (k == z_begin) {
+                slab.owned_boundary = lower;
+            }
+            std::swap(lower, upper);
+        }
+
+        // After the last swap the lower cache holds the x/y edges of layer z_end
+        if (lower_stale) {
+            std::fill(lower.begin(), lower.end(), -1);
+        }
+        slab.shared_boundary = std::move(lower);
+    }
+
+    // Generate a compact indexed mesh: every grid edge crossing is one shared vertex, faces are
+    // triangles indexing them, and triangleIndices are filled directly. No per-triangle edges
+    // are emitted. Slabs are extracted in parallel and stitched along their shared layers.
+    std::shared_ptr<MeshData> ScalarField3D::generate_mesh_indexed(float isolevel) const {
+        auto meshData = std::make_shared<MeshData>();
+        const int cell_layers = m_res_z - 1;
+        if (m_res_x < 2 || m_res_y < 2 || cell_layers < 1) {
+            return meshData;
+        }
+
+        MCBrickMask mask;
+        build_brick_mask(isolevel, mask);
+
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        const int slab_count = std::min(mask.bricks_z, num_threads == 1 ? 1 : num_threads * 4);
+        const int slab_depth = ((mask.bricks_z + slab_count - 1) / slab_count) * BRICK_SIZE;
+
+        std::vector<MCMeshSlab> slabs(slab_count);
+        parallel_for(slab_count, num_threads, [&](int slab) {
+            const int z_begin = slab * slab_depth;
+            const int z_end = std::min(cell_layers, z_begin + slab_depth);
+            if (z_begin < z_end) {
+                extract_indexed_slab(isolevel, z_begin, z_end, mask, slabs[slab]);
+            }
+        });
+
+        merge_mesh_slabs(slabs, true, 3, *meshData);
+        return meshData;
+    }
+
+    // Place a dual vertex from the isosurface crossings inside the box [lo, hi]. Surface nets
+    // takes their mean. Dual contouring minimizes the squared distance to the tangent planes at
+    // the crossings (normals from gradient_at), solved relative to the mean with a small
+    // regularization toward it so flat regions stay put, then clamped into the box.
+    Vec3 ScalarField3D::place_dual_vertex(const Vec3* crossings, int count, const Vec3& lo, const Vec3& hi,
+                                          DualMeshMode mode) const {
+        Vec3 mass(0, 0, 0);
+        for (int n = 0; n < count; ++n) {
+            mass += crossings[n];
+        }
+        mass = mass / static_cast<float>(count);
+        if (mode == DualMeshMode::SurfaceNets) {
+            return mass;
+        }
+
+        // Normal equations (A^T A + w I) x = A^T b for x relative to the mass point
+        float ata[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+        float atb[3] = {0, 0, 0};
+        for (int n = 0; n < count; ++n) {
+            const Vec3 normal = gradient_normalized(crossings[n]);
+            const float row[3] = {normal.x, normal.y, normal.z};
+            const float d = normal.dot(crossings[n] - mass);
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 3; ++c) {
+                    ata[r][c] += row[r] * row[c];
+                }
+                atb[r] += row[r] * d;
+            }
+        }
+        const float regularization = 0.05f;
+        for (int r = 0; r < 3; ++r) {
+            ata[r][r] += regularization;
+        }
+
+        // Cramer's rule; the regularization keeps the system positive definite
+        auto det3 = [](const float m[3][3]) {
+            return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                 - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                 + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+        };
+        const float det = det3(ata);
+        if (std::abs(det) < 1e-12f) {
+            return mass;
+        }
+        float solution[3];
+        for (int c = 0; c < 3; ++c) {
+            float m[3][3];
+            for (int r = 0; r < 3; ++r) {
+                for (int q = 0; q < 3; ++q) {
+                    m[r][q] = (q == c) ? atb[r] : ata[r][q];
+                }
+            }
+            solution[c] = det3(m) / det;
+        }
+
+        return Vec3(std::clamp(mass.x + solution[0], std::min(lo.x, hi.x), std::max(lo.x, hi.x)),
+                    std::clamp(mass.y + solution[1], std::min(lo.y, hi.y), std::max(lo.y, hi.y)),
+                    std::clamp(mass.z + solution[2], std::min(lo.z, hi.z), std::max(lo.z, hi.z)));
+    }
+
+    // Dual vertex of cell (i, j, k) from the crossings on its intersected MC edges
+    Vec3 ScalarField3D::dual_cell_vertex(int i, int j, int k, const float values[8], int edges, float isolevel,
+                                         DualMeshMode mode) const {
+        Vec3 corners[8];
+        for (int c = 0; c < 8; ++c) {
+            corners[c] = grid_point(i + MC_CORNER_OFFSETS[c][0], j + MC_CORNER_OFFSETS[c][1], k + MC_CORNER_OFFSETS[c][2]);
+        }
+
+        Vec3 crossings[12];
+        int count = 0;
+        for (int e = 0; e < 12; ++e) {
+            if (!(edges & (1 << e))) continue;
+            const int a = MC_EDGE_REFS[e].corner_a;
+            const int b = MC_EDGE_REFS[e].corner_b;
+            crossings[count++] = vertex_interpolate_robust(isolevel, corners[a], corners[b], values[a], values[b]);
+        }
+        return place_dual_vertex(crossings, count, corners[0], corners[6], mode);
+    }
+
+    // Dual extraction over cell layers [z_begin, z_end). Every active cell gets one vertex; every
+    // crossed grid edge at a cell origin yields a quad through the four cells around it, wound so
+    // its normal points toward increasing values like the MC output. Quads on the bottom layer
+    // reach into cell layer z_begin - 1, owned by the previous slab: those cells are recomputed
+    // here as duplicates and resolved to the previous slab's vertices when slabs are merged.
+    void ScalarField3D::extract_dual_slab(float isolevel, DualMeshMode mode, int z_begin, int z_end,
+                                          const MCBrickMask& mask, MCMeshSlab& slab) const {
+        const int cells_x = m_res_x - 1;
+        const int cell_plane = cells_x * (m_res_y - 1);
+        const int k_first = std::max(0, z_begin - 1);
+        std::vector<int> cell_vertex(static_cast<size_t>(z_end - k_first) * cell_plane, -1);
+        auto vertex_of = [&](int i, int j, int k) -> int {
+            return cell_vertex[static_cast<size_t>(k - k_first) * cell_plane + j * cells_x + i];
+        };
+
+        auto emit_quad = [&](int a, int b, int c, int d, bool flip) {
+            if (a < 0 || b < 0 || c < 0 || d < 0) return;
+            if (flip) std::swap(b, d);
+            slab.indices.insert(slab.indices.end(), {a, b, c, d});
+        };
+
+        for (int k = k_first; k < z_end; ++k) {
+            const int bz = k / BRICK_SIZE;
+            if (!mask.layers[bz]) {
+                k = (bz + 1) * BRICK_SIZE - 1;
+                continue;
+            }
+
+            for (int j = 0; j < m_res_y - 1; ++j) {
+                const int by = j / BRICK_SIZE;
+                const size_t row = static_cast<size_t>(bz) * mask.bricks_y + by;
+                if (!mask.rows[row]) {
+                    j = (by + 1) * BRICK_SIZE - 1;
+                    continue;
+                }
+
+                for (int bx = 0; bx < mask.bricks_x; ++bx) {
+                    if (!mask.bricks[row * mask.bricks_x + bx]) continue;
+
+                    const int i_end = std::min(m_res_x - 1, (bx + 1) * BRICK_SIZE);
+                    for (int i = bx * BRICK_SIZE; i < i_end; ++i) {
+                        float values[8];
+                        bool inside[8];
+                        int cubeindex = 0;
+                        for (int c = 0; c < 8; ++c) {
+                            values[c] = m_field_values[get_index(i + MC_CORNER_OFFSETS[c][0],
+                                                                 j + MC_CORNER_OFFSETS[c][1],
+                                                                 k + MC_CORNER_OFFSETS[c][2])];
+                            inside[c] = classify_vertex(values[c], isolevel) == alice2::VertexClass::NEGATIVE;
+                            if (!inside[c]) {
+                                cubeindex |= 1 << c;
+                            }
+                        }
+
+                        const int edges = EDGE_TABLE[cubeindex];
+                        if (edges == 0) continue;
+
+                        const int id = static_cast<int>(slab.positions.size());
+                        slab.positions.push_back(dual_cell_vertex(i, j, k, values, edges, isolevel, mode));
+                        cell_vertex[static_cast<size_t>(k - k_first) * cell_plane + j * cells_x + i] = id;
+                        if (k < z_begin) continue;
+
+                        // Edges leaving the cell origin along x (corner 1), y (corner 3) and z (corner 4);
+                        // the winding is reversed when the origin is the outside end
+                        if (j > 0 && k > 0 && inside[0] != inside[1]) {
+                            emit_quad(vertex_of(i, j - 1, k - 1), vertex_of(i, j, k - 1), id, vertex_of(i, j - 1, k), !inside[0]);
+                        }
+                        if (i > 0 && k > 0 && inside[0] != inside[3]) {
+                            emit_quad(vertex_of(i - 1, j, k - 1), vertex_of(i - 1, j, k), id, vertex_of(i, j, k - 1), !inside[0]);
+                        }
+                        if (i > 0 && j > 0 && inside[0] != inside[4]) {
+                            emit_quad(vertex_of(i - 1, j - 1, k), vertex_of(i, j - 1, k), id, vertex_of(i - 1, j, k), !inside[0]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Cell layer z_end - 1 is owned here; cell layer z_begin - 1 duplicates the previous slab's
+        auto layer_ids = [&](int k) {
+            return std::vector<int>(cell_vertex.begin() + static_cast<size_t>(k - k_first) * cell_plane,
+                                    cell_vertex.begin() + static_cast<size_t>(k - k_first + 1) * cell_plane);
+        };
+        slab.owned_boundary = layer_ids(z_end - 1);
+        if (z_begin > 0) {
+            slab.shared_boundary = layer_ids(z_begin - 1);
+        }
+    }
+
+    // Drop a vertex slot once no face references it; its grid edge may be re-created later
+    static void release_incremental_vertex(MCIncrementalMesh& state, int vertex) {
+        if (state.vertex_edges[vertex] == MCIncrementalMesh::FREE_EDGE) return;
+        state.edge_vertices.erase(state.vertex_edges[vertex]);
+        state.vertex_edges[vertex] = MCIncrementalMesh::FREE_EDGE;
+        state.normal_sums[vertex] = Vec3(0, 0, 0);
+        state.free_vertices.push_back(vertex);
+    }
+
+    // Swap-remove every face of a brick from the mesh, undoing its normal contributions.
+    // The face moved into each hole keeps its brick list and slot in sync.
+    static void remove_brick_faces(MCIncrementalMesh& state, int brick, std::vector<int>& touched) {
+        MeshData& mesh = *state.mesh;
+        std::vector<int>& faces = state.brick_faces[brick];
+
+        for (size_t n = 0; n < faces.size(); ++n) {
+            const int face = faces[n];
+            const MeshFace& removed = mesh.faces[face];
+            const Vec3& a = mesh.vertices[removed.vertices[0]].position;
+            const Vec3& b = mesh.vertices[removed.vertices[1]].position;
+            const Vec3& c = mesh.vertices[removed.vertices[2]].position;
+            const Vec3 normal = a.cross(b) + b.cross(c) + c.cross(a);
+            for (int v : removed.vertices) {
+                state.normal_sums[v] -= normal;
+                touched.push_back(v);
+                if (--state.vertex_refs[v] == 0) {
+                    release_incremental_vertex(state, v);
+                }
+            }
+
+            const int last = static_cast<int>(mesh.faces.size()) - 1;
+            if (face != last) {
+                mesh.faces[face] = std::move(mesh.faces[last]);
+                std::copy_n(mesh.triangleIndices.begin() + 3 * last, 3, mesh.triangleIndices.begin() + 3 * face);
+                state.face_bricks[face] = state.face_bricks[last];
+                state.face_slots[face] = state.face_slots[last];
+                state.brick_faces[state.face_bricks[face]][state.face_slots[face]] = face;
+            }
+            mesh.faces.pop_back();
+            mesh.triangleIndices.resize(mesh.triangleIndices.size() - 3);
+            state.face_bricks.pop_back();
+            state.face_slots.pop_back();
+        }
+        faces.clear();
+    }
+
+    // Renumber live vertices densely once enough slots have been freed
+    static void compact_incremental_mesh(MCIncrementalMesh& state) {
+        MeshData& mesh = *state.mesh;
+        std::vector<int> remap(mesh.vertices.size(), -1);
+        int live = 0;
+        for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+            if (state.vertex_edges[v] == MCIncrementalMesh::FREE_EDGE) continue;
+            remap[v] = live;
+            mesh.vertices[live] = mesh.vertices[v];
+            state.vertex_refs[live] = state.vertex_refs[v];
+            state.normal_sums[live] = state.normal_sums[v];
+            state.vertex_edges[live] = state.vertex_edges[v];
+            state.edge_vertices[state.vertex_edges[live]] = live;
+            ++live;
+        }
+        mesh.vertices.resize(live);
+        state.vertex_refs.resize(live);
+        state.normal_sums.resize(live);
+        state.vertex_edges.resize(live);
+        state.free_vertices.clear();
+
+        for (auto& face : mesh.faces) {
+            for (int& v : face.vertices) v = remap[v];
+        }
+        for (int& v : mesh.triangleIndices) v = remap[v];
+    }
+
+    // Polygonize the cells of one brick into the incremental mesh. Vertices are looked up by
+    // grid edge (point index * 3 + axis), so faces of neighbouring bricks share them.
+    void ScalarField3D::polygonize_brick(MCIncrementalMesh& state, float isolevel, int bx, int by, int bz,
+                                         std::vector<int>& touched) const {
+        MeshData& mesh = *state.mesh;
+        const int brick = static_cast<int>((static_cast<size_t>(bz) * brick_count(m_res_y) + by) * brick_count(m_res_x) + bx);
+        const int i_end = std::min(m_res_x - 1, (bx + 1) * BRICK_SIZE);
+        const int j_end = std::min(m_res_y - 1, (by + 1) * BRICK_SIZE);
+        const int k_end = std::min(m_res_z - 1, (bz + 1) * BRICK_SIZE);
+        const Color color(0.8f, 0.8f, 0.9f);
+
+        for (int k = bz * BRICK_SIZE; k < k_end; ++k) {
+            for (int j = by * BRICK_SIZE; j < j_end; ++j) {
+                for (int i = bx * BRICK_SIZE; i < i_end; ++i) {
+                    float values[8];
+                    int cubeindex = 0;
+                    for (int c = 0; c < 8; ++c) {
+                        values[c] = m_field_values[get_index(i + MC_CORNER_OFFSETS[c][0],
+                                                             j + MC_CORNER_OFFSETS[c][1],
+                                                             k + MC_CORNER_OFFSETS[c][2])];
+                        if (classify_vertex(values[c], isolevel) != alice2::VertexClass::NEGATIVE) {
+                            cubeindex |= 1 << c;
+                        }
+                    }
+
+                    const int edges = EDGE_TABLE[cubeindex];
+                    if (edges == 0) continue;
+
+                    auto corner_point = [&](int c) {
+                        return grid_point(i + MC_CORNER_OFFSETS[c][0],
+                                          j + MC_CORNER_OFFSETS[c][1],
+                                          k + MC_CORNER_OFFSETS[c][2]);
+                    };
+
+                    int edge_vertex[12];
+                    for (int e = 0; e < 12; ++e) {
+                        if (!(edges & (1 << e))) continue;
+
+                        const MCEdgeRef& ref = MC_EDGE_REFS[e];
+                        const int axis = ref.cache == 2 ? 2 : ref.axis;
+                        const int point = get_index(i + ref.di, j + ref.dj, k + (ref.cache == 1 ? 1 : 0));
+                        const uint64_t key = static_cast<uint64_t>(point) * 3 + axis;
+
+                        auto found = state.edge_vertices.find(key);
+                        if (found != state.edge_vertices.end()) {
+                            edge_vertex[e] = found->second;
+                            continue;
+                        }
+
+                        int vertex;
+                        if (!state.free_vertices.empty()) {
+                            vertex = state.free_vertices.back();
+                            state.free_vertices.pop_back();
+                        } else {
+                            vertex = static_cast<int>(mesh.vertices.size());
+                            mesh.vertices.emplace_back();
+                            state.vertex_refs.push_back(0);
+                            state.normal_sums.push_back(Vec3(0, 0, 0));
+                            state.vertex_edges.push_back(MCIncrementalMesh::FREE_EDGE);
+                        }
+                        const int a = ref.corner_a;
+                        const int b = ref.corner_b;
+                        mesh.vertices[vertex] = MeshVertex(vertex_interpolate_robust(isolevel,
+                            corner_point(a), corner_point(b), values[a], values[b]), Vec3(0, 0, 0), color);
+                        state.vertex_refs[vertex] = 0;
+                        state.normal_sums[vertex] = Vec3(0, 0, 0);
+                        state.vertex_edges[vertex] = key;
+                        state.edge_vertices.emplace(key, vertex);
+                        touched.push_back(vertex);
+                        edge_vertex[e] = vertex;
+                    }
+
+                    for (int t = 0; t < 16 && TRI_TABLE[cubeindex][t] != -1; t += 3) {
+                        const int v0 = edge_vertex[TRI_TABLE[cubeindex][t]];
+                        const int v1 = edge_vertex[TRI_TABLE[cubeindex][t + 1]];
+                        const int v2 = edge_vertex[TRI_TABLE[cubeindex][t + 2]];
+                        if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+
+                        const Vec3& p0 = mesh.vertices[v0].position;
+                        const Vec3& p1 = mesh.vertices[v1].position;
+                        const Vec3& p2 = mesh.vertices[v2].position;
+                        const Vec3 normal = p0.cross(p1) + p1.cross(p2) + p2.cross(p0);
+
+                        MeshFace face;
+                        face.vertices = {v0, v1, v2};
+                        face.normal = normal.normalized();
+                        face.color = color;
+                        for (int v : face.vertices) {
+                            state.normal_sums[v] += normal;
+                            state.vertex_refs[v]++;
+                            touched.push_back(v);
+                        }
+
+                        state.face_bricks.push_back(brick);
+                        state.face_slots.push_back(static_cast<int>(state.brick_faces[brick].size()));
+                        state.brick_faces[brick].push_back(static_cast<int>(mesh.faces.size()));
+                        mesh.triangleIndices.insert(mesh.triangleIndices.end(), {v0, v1, v2});
+                        mesh.faces.push_back(std::move(face));
+                    }
+                }
+            }
+        }
+    }
+
+    // Incremental extraction. The first call (or a change of isolevel or resolution) builds the
+    // whole surface; later calls compare brick versions against the state, remove the faces of
+    // bricks written since, and re-polygonize only those bricks. The mesh is patched in place,
+    // so the cost follows the size of the edit rather than the grid. Face order and vertex ids
+    // differ from generate_mesh_indexed, the surface is the same.
+    std::shared_ptr<MeshData> ScalarField3D::update_mesh_incremental(MCIncrementalMesh& state, float isolevel) const {
+        const int bricks_x = brick_count(m_res_x);
+        const int bricks_y = brick_count(m_res_y);
+        const int bricks_z = brick_count(m_res_z);
+        const size_t brick_total = static_cast<size_t>(bricks_x) * bricks_y * bricks_z;
+
+        if (!state.mesh || state.isolevel != isolevel || state.brick_versions.size() != brick_total) {
+            state = MCIncrementalMesh();
+            state.mesh = std::make_shared<MeshData>();
+            state.isolevel = isolevel;
+            state.brick_versions.assign(brick_total, ~uint64_t(0));     // matches no field version
+            state.brick_faces.resize(brick_total);
+        }
+        state.last_dirty_bricks = 0;
+        if (m_res_x < 2 || m_res_y < 2 || m_res_z < 2) {
+            return state.mesh;
+        }
+
+        update_bricks();
+
+        std::vector<int> dirty;
+        for (size_t b = 0; b < brick_total; ++b) {
+            if (state.brick_versions[b] != brick_version(b)) {
+                dirty.push_back(static_cast<int>(b));
+            }
+        }
+
+        // Remove every dirty brick first so no stale vertex on a changed edge is reused
+        std::vector<int> touched;
+        for (int b : dirty) {
+            remove_brick_faces(state, b, touched);
+        }
+
+        for (int b : dirty) {
+            const FieldBrick& summary = m_bricks[b];
+            const bool all_negative = classify_vertex(summary.max_value, isolevel) == alice2::VertexClass::NEGATIVE;
+            const bool all_positive = classify_vertex(summary.min_value, isolevel) != alice2::VertexClass::NEGATIVE;
+            if (!all_negative && !all_positive) {
+                polygonize_brick(state, isolevel, b % bricks_x, (b / bricks_x) % bricks_y, b / (bricks_x * bricks_y), touched);
+            }
+            state.brick_versions[b] = brick_version(b);
+        }
+
+        // Vertices whose faces changed get fresh normals; vertices created only by skipped
+        // degenerate triangles are released again
+        MeshData& mesh = *state.mesh;
+        for (int v : touched) {
+            if (state.vertex_refs[v] == 0) {
+                release_incremental_vertex(state, v);
+                continue;
+            }
+            const float length = state.normal_sums[v].length();
+            mesh.vertices[v].normal = (length > 1e-12f) ? state.normal_sums[v] / length : Vec3(0, 0, 1);
+        }
+
+        if (state.free_vertices.size() * 4 > mesh.vertices.size()) {
+            compact_incremental_mesh(state);
+        }
+
+        mesh.triangulationDirty = false;
+        state.last_dirty_bricks = static_cast<int>(dirty.size());
+        return state.mesh;
+    }
+
+    // Cell strides of the progressive levels, coarse to fine. Each divides BRICK_SIZE, so a
+    // coarse cell never straddles bricks and the brick mask stays valid for it.
+    static const int MC_PROGRESSIVE_STRIDES[] = {4, 2, 1};
+    static const int MC_PROGRESSIVE_LEVELS = 3;
+
+    // Polygonize one row of stride-sized cells into the mesh being built. Corners past the last
+    // grid point are clamped to it; vertices are shared through the state's grid-edge map.
+    // Returns the number of cells visited.
+    int ScalarField3D::polygonize_progressive_row(MCProgressiveMesh& state, const MCBrickMask& mask,
+                                                  int stride, int j, int k) const {
+        const size_t row = static_cast<size_t>(k / BRICK_SIZE) * mask.bricks_y + j / BRICK_SIZE;
+        if (!mask.rows[row]) return 0;
+
+        MeshData& mesh = *state.building;
+        const float isolevel = state.isolevel;
+        const Color color(0.8f, 0.8f, 0.9f);
+        int cells = 0;
+
+        auto corner_coords = [&](int i, int c, int& x, int& y, int& z) {
+            x = std::min(m_res_x - 1, i + MC_CORNER_OFFSETS[c][0] * stride);
+            y = std::min(m_res_y - 1, j + MC_CORNER_OFFSETS[c][1] * stride);
+            z = std::min(m_res_z - 1, k + MC_CORNER_OFFSETS[c][2] * stride);
+        };
+
+        for (int i = 0; i < m_res_x - 1; i += stride) {
+            const int bx = i / BRICK_SIZE;
+            if (!mask.bricks[row * mask.bricks_x + bx]) {
+                i = (bx + 1) * BRICK_SIZE - stride;
+                continue;
+            }
+            ++cells;
+
+            Vec3 corners[8];
+            float values[8];
+            int cubeindex = 0;
+            for (int c = 0; c < 8; ++c) {
+                int x, y, z;
+                corner_coords(i, c, x, y, z);
+                corners[c] = grid_point(x, y, z);
+                values[c] = m_field_values[get_index(x, y, z)];
+                if (classify_vertex(values[c], isolevel) != alice2::VertexClass::NEGATIVE) {
+                    cubeindex |= 1 << c;
+                }
+            }
+
+            const int edges = EDGE_TABLE[cubeindex];
+            if (edges == 0) continue;
+
+            int edge_vertex[12];
+            for (int e = 0; e < 12; ++e) {
+                if (!(edges & (1 << e))) continue;
+
+                const MCEdgeRef& ref = MC_EDGE_REFS[e];
+                const int axis = ref.cache == 2 ? 2 : ref.axis;
+                int x, y, z;
+                corner_coords(i, ref.corner_a, x, y, z);
+                const uint64_t key = static_cast<uint64_t>(get_index(x, y, z)) * 3 + axis;
+
+                auto [found, inserted] = state.edge_vertices.emplace(key, static_cast<int>(mesh.vertices.size()));
+                if (inserted) {
+                    const int a = ref.corner_a;
+                    const int b = ref.corner_b;
+                    mesh.vertices.emplace_back(vertex_interpolate_robust(isolevel, corners[a], corners[b],
+                                                                         values[a], values[b]),
+                                               Vec3(0, 0, 1), color);
+                    state.normal_sums.push_back(Vec3(0, 0, 0));
+                }
+                edge_vertex[e] = found->second;
+            }
+
+            for (int t = 0; t < 16 && TRI_TABLE[cubeindex][t] != -1; t += 3) {
+                const int v0 = edge_vertex[TRI_TABLE[cubeindex][t]];
+                const int v1 = edge_vertex[TRI_TABLE[cubeindex][t + 1]];
+                const int v2 = edge_vertex[TRI_TABLE[cubeindex][t + 2]];
+                if (v0 == v1 || v1 == v2 || v2 == v0) continue;
+
+                const Vec3& p0 = mesh.vertices[v0].position;
+                const Vec3& p1 = mesh.vertices[v1].position;
+                const Vec3& p2 = mesh.vertices[v2].position;
+                const Vec3 normal = p0.cross(p1) + p1.cross(p2) + p2.cross(p0);
+                state.normal_sums[v0] += normal;
+                state.normal_sums[v1] += normal;
+                state.normal_sums[v2] += normal;
+
+                MeshFace face;
+                face.vertices = {v0, v1, v2};
+                face.normal = normal.normalized();
+                face.color = color;
+                mesh.faces.push_back(std::move(face));
+                mesh.triangleIndices.insert(mesh.triangleIndices.end(), {v0, v1, v2});
+            }
+        }
+        return cells;
+    }
+
+    // Progressive extraction: builds one level at a time, row by row, stopping when the budget
+    // is spent and resuming from the same row on the next call. Coarse levels that would leave
+    // fewer than two cells along an axis are skipped.
+    bool ScalarField3D::extract_progressive(MCProgressiveMesh& state, float isolevel,
+                                            const MCExtractBudget& budget) const {
+        if (!state.started || state.isolevel != isolevel || state.field_version != m_write_version) {
+            std::shared_ptr<MeshData> shown = state.mesh;
+            state.cancel();
+            state.mesh = shown;
+            state.started = true;
+            state.isolevel = isolevel;
+            state.field_version = m_write_version;
+            state.building = std::make_shared<MeshData>();
+        }
+        if (state.finished) return true;
+
+        const int min_cells = std::min({m_res_x, m_res_y, m_res_z}) - 1;
+        if (min_cells < 1) {
+            state.mesh = state.building;
+            state.finished = true;
+            return true;
+        }
+
+        MCBrickMask mask;
+        build_brick_mask(isolevel, mask);
+
+        const auto start = std::chrono::steady_clock::now();
+        int cells = 0;
+        bool first_row = true;
+
+        while (state.level < MC_PROGRESSIVE_LEVELS) {
+            const int stride = MC_PROGRESSIVE_STRIDES[state.level];
+            if (stride > 1 && min_cells < 2 * stride) {
+                ++state.level;
+                continue;
+            }
+
+            while (state.next_k < m_res_z - 1) {
+                if (!first_row) {
+                    const float elapsed_ms = std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - start).count();
+                    if ((budget.time_ms > 0.0f && elapsed_ms >= budget.time_ms) ||
+                        (budget.max_cells > 0 && cells >= budget.max_cells)) {
+                        break;
+                    }
+                }
+                first_row = false;
+
+                cells += polygonize_progressive_row(state, mask, stride, state.next_j, state.next_k);
+                state.next_j += stride;
+                if (state.next_j >= m_res_y - 1) {
+                    state.next_j = 0;
+                    state.next_k += stride;
+                }
+            }
+
+            if (state.next_k < m_res_z - 1) break;
+
+            // Level complete: finish its normals and show it in place of the previous level
+            MeshData& mesh = *state.building;
+            for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+                const float length = state.normal_sums[v].length();
+                mesh.vertices[v].normal = (length > 1e-12f) ? state.normal_sums[v] / length : Vec3(0, 0, 1);
+            }
+            mesh.triangulationDirty = false;
+            state.mesh = state.building;
+            state.completed_stride = stride;
+
+            ++state.level;
+            state.next_j = 0;
+            state.next_k = 0;
+            state.building = std::make_shared<MeshData>();
+            state.normal_sums.clear();
+            state.edge_vertices.clear();
+        }
+
+        if (state.level >= MC_PROGRESSIVE_LEVELS) {
+            state.finished = true;
+            state.building.reset();
+            state.normal_sums.clear();
+            state.edge_vertices.clear();
+            return true;
+        }
+
+        // Nothing completed yet: show the first level as far as it got
+        if (state.completed_stride == 0) {
+            MeshData& mesh = *state.building;
+            for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+                const float length = state.normal_sums[v].length();
+                mesh.vertices[v].normal = (length > 1e-12f) ? state.normal_sums[v] / length : Vec3(0, 0, 1);
+            }
+            mesh.triangulationDirty = false;
+            state.mesh = state.building;
+        }
+        return false;
+    }
+
+    // Dual mesh: about one quad per crossed grid edge instead of up to five MC triangles per cell.
+    // Uses the same brick mask, slab split and slab merge as generate_mesh_indexed.
+    std::shared_ptr<MeshData> ScalarField3D::generate_mesh_dual(float isolevel, DualMeshMode mode) const {
+        auto meshData = std::make_shared<MeshData>();
+        const int cell_layers = m_res_z - 1;
+        if (m_res_x < 2 || m_res_y < 2 || cell_layers < 1) {
+            return meshData;
+        }
+
+        MCBrickMask mask;
+        build_brick_mask(isolevel, mask);
+        if (m_gradient_cache_enabled) {
+            update_gradient_field();    // dual contouring reads gradients from every slab worker
+        }
+
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        const int slab_count = std::min(mask.bricks_z, num_threads == 1 ? 1 : num_threads * 4);
+        const int slab_depth = ((mask.bricks_z + slab_count - 1) / slab_count) * BRICK_SIZE;
+
+        std::vector<MCMeshSlab> slabs(slab_count);
+        parallel_for(slab_count, num_threads, [&](int slab) {
+            const int z_begin = slab * slab_depth;
+            const int z_end = std::min(cell_layers, z_begin + slab_depth);
+            if (z_begin < z_end) {
+                extract_dual_slab(isolevel, mode, z_begin, z_end, mask, slabs[slab]);
+            }
+        });
+
+        merge_mesh_slabs(slabs, false, 4, *meshData);
+        return meshData;
+    }
+
+    // Min/max over the grid points of the cube of cells [x0, x0 + size)^3, clipped to the grid.
+    // Brick-aligned cubes combine brick summaries; smaller ones are scanned.
+    void ScalarField3D::region_range(int x0, int y0, int z0, int size, float& min_value, float& max_value) const {
+        const int x1 = std::min(m_res_x - 1, x0 + size);
+        const int y1 = std::min(m_res_y - 1, y0 + size);
+        const int z1 = std::min(m_res_z - 1, z0 + size);
+
+        if (size >= BRICK_SIZE) {
+            const int bricks_x = brick_count(m_res_x);
+            const int bricks_y = brick_count(m_res_y);
+            min_value = m_bricks[(static_cast<size_t>(z0 / BRICK_SIZE) * bricks_y + y0 / BRICK_SIZE) * bricks_x + x0 / BRICK_SIZE].min_value;
+            max_value = min_value;
+            for (int bz = z0 / BRICK_SIZE; bz <= (z1 - 1) / BRICK_SIZE; ++bz) {
+                for (int by = y0 / BRICK_SIZE; by <= (y1 - 1) / BRICK_SIZE; ++by) {
+                    for (int bx = x0 / BRICK_SIZE; bx <= (x1 - 1) / BRICK_SIZE; ++bx) {
+                        const FieldBrick& brick = m_bricks[(static_cast<size_t>(bz) * bricks_y + by) * bricks_x + bx];
+                        min_value = std::min(min_value, brick.min_value);
+                        max_value = std::max(max_value, brick.max_value);
+                    }
+                }
+            }
+            return;
+        }
+
+        min_value = m_field_values[get_index(x0, y0, z0)];
+        max_value = min_value;
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    const float value = m_field_values[get_index(x, y, z)];
+                    min_value = std::min(min_value, value);
+                    max_value = std::max(max_value, value);
+                }
+            }
+        }
+    }
+
+    // A coarse leaf is acceptable when trilinear interpolation of its 8 corners reproduces every
+    // grid value inside it to within max_error and never disagrees on which side of the isolevel
+    // a point lies, so collapsing it loses no topology.
+    bool ScalarField3D::octree_leaf_fits(int x0, int y0, int z0, int size, float isolevel, float max_error) const {
+        float corners[8];
+        for (int c = 0; c < 8; ++c) {
+            corners[c] = m_field_values[get_index(x0 + MC_CORNER_OFFSETS[c][0] * size,
+                                                  y0 + MC_CORNER_OFFSETS[c][1] * size,
+                                                  z0 + MC_CORNER_OFFSETS[c][2] * size)];
+        }
+
+        const float inv_size = 1.0f / size;
+        for (int z = 0; z <= size; ++z) {
+            const float tz = z * inv_size;
+            for (int y = 0; y <= size; ++y) {
+                const float ty = y * inv_size;
+                const float c0 = (corners[0] * (1 - ty) + corners[3] * ty);
+                const float c1 = (corners[1] * (1 - ty) + corners[2] * ty);
+                const float c4 = (corners[4] * (1 - ty) + corners[7] * ty);
+                const float c5 = (corners[5] * (1 - ty) + corners[6] * ty);
+                const float* row = &m_field_values[get_index(x0, y0 + y, z0 + z)];
+                for (int x = 0; x <= size; ++x) {
+                    const float tx = x * inv_size;
+                    const float fitted = (c0 * (1 - tx) + c1 * tx) * (1 - tz) + (c4 * (1 - tx) + c5 * tx) * tz;
+                    const float value = row[x];
+                    if (std::abs(value - fitted) > max_error) return false;
+                    const bool inside = classify_vertex(value, isolevel) == alice2::VertexClass::NEGATIVE;
+                    const bool fitted_inside = classify_vertex(fitted, isolevel) == alice2::VertexClass::NEGATIVE;
+                    if (inside != fitted_inside) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Top-down build: nodes without a crossing become (possibly huge) empty leaves; nodes with a
+    // crossing stay coarse only if they lie inside the grid, respect the size and focus limits
+    // and pass octree_leaf_fits. Returns the node index, or -1 outside the grid.
+    int ScalarField3D::build_octree_node(MCOctree& tree, float isolevel, const AdaptiveMeshSettings& settings,
+                                         int x0, int y0, int z0, int size) const {
+        if (x0 >= m_res_x - 1 || y0 >= m_res_y - 1 || z0 >= m_res_z - 1) {
+            return -1;
+        }
+
+        float min_value, max_value;
+        region_range(x0, y0, z0, size, min_value, max_value);
+        const bool has_surface = classify_vertex(min_value, isolevel) == alice2::VertexClass::NEGATIVE &&
+                                 classify_vertex(max_value, isolevel) != alice2::VertexClass::NEGATIVE;
+
+        const int index = static_cast<int>(tree.nodes.size());
+        tree.nodes.push_back({x0, y0, z0, size, {-1, -1, -1, -1, -1, -1, -1, -1}, true, has_surface});
+        if (!has_surface || size == 1) {
+            return index;
+        }
+
+        const bool inside = x0 + size < m_res_x && y0 + size < m_res_y && z0 + size < m_res_z;
+        bool coarse_ok = inside && size <= settings.max_leaf_cells;
+        if (coarse_ok && settings.focus_distance > 0.0f) {
+            const Vec3 lo = grid_point(x0, y0, z0);
+            const Vec3 hi = grid_point(x0 + size, y0 + size, z0 + size);
+            const Vec3 nearest = Vec3(std::clamp(settings.focus_point.x, lo.x, hi.x),
+                                      std::clamp(settings.focus_point.y, lo.y, hi.y),
+                                      std::clamp(settings.focus_point.z, lo.z, hi.z));
+            const float level = std::log2(static_cast<float>(size));
+            coarse_ok = (nearest - settings.focus_point).length() >= level * settings.focus_distance;
+        }
+        if (coarse_ok && octree_leaf_fits(x0, y0, z0, size, isolevel, settings.max_error)) {
+            return index;
+        }
+
+        tree.nodes[index].leaf = false;
+        const int half = size / 2;
+        for (int c = 0; c < 8; ++c) {
+            const int child = build_octree_node(tree, isolevel, settings,
+                                                x0 + ((c & 1) ? half : 0),
+                                                y0 + ((c & 2) ? half : 0),
+                                                z0 + ((c & 4) ? half : 0), half);
+            tree.nodes[index].children[c] = child;
+        }
+        return index;
+    }
+
+    // Dual vertex of a leaf from every grid edge crossing inside it, boundary edges included
+    Vec3 ScalarField3D::octree_leaf_vertex(int x0, int y0, int z0, int size, float isolevel, DualMeshMode mode) const {
+        const int x1 = std::min(m_res_x - 1, x0 + size);
+        const int y1 = std::min(m_res_y - 1, y0 + size);
+        const int z1 = std::min(m_res_z - 1, z0 + size);
+        const int ends[3] = {x1, y1, z1};
+
+        std::vector<Vec3> crossings;
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    const float value = m_field_values[get_index(x, y, z)];
+                    const bool inside = classify_vertex(value, isolevel) == alice2::VertexClass::NEGATIVE;
+                    const int coords[3] = {x, y, z};
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (coords[axis] + 1 > ends[axis]) continue;
+                        const int nx = x + (axis == 0);
+                        const int ny = y + (axis == 1);
+                        const int nz = z + (axis == 2);
+                        const float next = m_field_values[get_index(nx, ny, nz)];
+                        if (inside == (classify_vertex(next, isolevel) == alice2::VertexClass::NEGATIVE)) continue;
+                        crossings.push_back(vertex_interpolate_robust(isolevel, grid_point(x, y, z),
+                                                                      grid_point(nx, ny, nz), value, next));
+                    }
+                }
+            }
+        }
+        if (crossings.empty()) {
+            return (grid_point(x0, y0, z0) + grid_point(x1, y1, z1)) * 0.5f;
+        }
+        return place_dual_vertex(crossings.data(), static_cast<int>(crossings.size()),
+                                 grid_point(x0, y0, z0), grid_point(x1, y1, z1), mode);
+    }
+
+    // Adaptive dual contouring. Faces are generated on minimal octree edges: an edge of a leaf
+    // that no smaller neighbour subdivides. The four leaves around such an edge (three when a
+    // larger leaf covers two positions) are joined when the edge's end points lie on opposite
+    // sides of the isolevel. Neighbours of different sizes share the same face, so resolution
+    // changes need no separate transition cells and leave no cracks.
+    std::shared_ptr<MeshData> ScalarField3D::generate_mesh_adaptive(float isolevel, const AdaptiveMeshSettings& settings) const {
+        auto meshData = std::make_shared<MeshData>();
+        const int cells[3] = {m_res_x - 1, m_res_y - 1, m_res_z - 1};
+        if (cells[0] < 1 || cells[1] < 1 || cells[2] < 1) {
+            return meshData;
+        }
+        update_bricks();
+
+        int root_size = 1;
+        while (root_size < std::max({cells[0], cells[1], cells[2]})) {
+            root_size *= 2;
+        }
+        MCOctree tree;
+        tree.root = build_octree_node(tree, isolevel, settings, 0, 0, 0, root_size);
+
+        MCMeshSlab slab;
+        std::vector<int> leaf_vertex(tree.nodes.size(), -1);
+        auto vertex_of = [&](int leaf) {
+            if (leaf_vertex[leaf] < 0) {
+                const MCOctreeNode& node = tree.nodes[leaf];
+                leaf_vertex[leaf] = static_cast<int>(slab.positions.size());
+                slab.positions.push_back(octree_leaf_vertex(node.x0, node.y0, node.z0, node.size, isolevel, settings.mode));
+            }
+            return leaf_vertex[leaf];
+        };
+
+        // Cells around an edge along axis a, in (b, c) order (0,0), (1,0), (1,1), (0,1) with
+        // b = a + 1 and c = a + 2 (mod 3); this winding faces +a
+        static const int AROUND[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+        for (int index = 0; index < static_cast<int>(tree.nodes.size()); ++index) {
+            const MCOctreeNode& node = tree.nodes[index];
+            if (!node.leaf || !node.has_surface) continue;
+
+            const int origin[3] = {node.x0, node.y0, node.z0};
+            const int size = node.size;
+            for (int a = 0; a < 3; ++a) {
+                const int b = (a + 1) % 3;
+                const int c = (a + 2) % 3;
+                for (int u = 0; u < 2; ++u) {
+                    for (int v = 0; v < 2; ++v) {
+                        int p0[3] = {origin[0], origin[1], origin[2]};
+                        p0[b] += u * size;
+                        p0[c] += v * size;
+                        int p1[3] = {p0[0], p0[1], p0[2]};
+                        p1[a] += size;
+
+                        const bool inside0 = classify_vertex(m_field_values[get_index(p0[0], p0[1], p0[2])], isolevel) == alice2::VertexClass::NEGATIVE;
+                        const bool inside1 = classify_vertex(m_field_values[get_index(p1[0], p1[1], p1[2])], isolevel) == alice2::VertexClass::NEGATIVE;
+                        if (inside0 == inside1) continue;
+
+                        // Leaves around the edge; one cell per leaf suffices since any leaf at least
+                        // as large as this one covers the whole edge
+                        int around[4];
+                        bool valid = true;
+                        for (int q = 0; q < 4 && valid; ++q) {
+                            int cell[3];
+                            cell[a] = origin[a];
+                            cell[b] = p0[b] - 1 + AROUND[q][0];
+                            cell[c] = p0[c] - 1 + AROUND[q][1];
+                            valid = cell[b] >= 0 && cell[b] < cells[b] && cell[c] >= 0 && cell[c] < cells[c];
+                            around[q] = valid ? tree.locate(cell[0], cell[1], cell[2]) : -1;
+                            valid = valid && around[q] >= 0;
+                        }
+                        if (!valid) continue;
+
+                        // Minimal edge owned by the first same-size leaf around it
+                        bool minimal = true;
+                        int owner = -1;
+                        for (int q = 0; q < 4; ++q) {
+                            const int neighbour_size = tree.nodes[around[q]].size;
+                            if (neighbour_size < size) minimal = false;
+                            if (neighbour_size == size && owner < 0) owner = around[q];
+                        }
+                        if (!minimal || owner != index) continue;
+
+                        int polygon[4];
+                        int corners = 0;
+                        for (int q = 0; q < 4; ++q) {
+                            if (corners > 0 && polygon[corners - 1] == around[q]) continue;
+                            polygon[corners++] = around[q];
+                        }
+                        if (corners > 1 && polygon[corners - 1] == polygon[0]) --corners;
+                        if (corners < 3) continue;
+
+                        for (int q = 0; q < corners; ++q) {
+                            polygon[q] = vertex_of(polygon[q]);
+                        }
+                        if (!inside0) {
+                            std::reverse(polygon, polygon + corners);
+                        }
+                        for (int t = 1; t + 1 < corners; ++t) {
+                            slab.indices.insert(slab.indices.end(), {polygon[0], polygon[t], polygon[t + 1]});
+                        }
+                    }
+                }
+            }
+        }
+
+        merge_mesh_slabs(std::vector<MCMeshSlab>{std::move(slab)}, true, 3, *meshData);
+        return meshData;
+    }
+
     // Trilinear interpolation sampling
     float ScalarField3D::sample_trilinear(const Vec3& p) const {
+        return sample_channel(m_field_values.data(), p);
+    }
+
+    // Trilinear interpolation of a per-grid-point channel (field values or a gradient component)
+    float ScalarField3D::sample_channel(const float* values, const Vec3& p) const {
         // Convert world position to grid coordinates
         float fx = (p.x - m_min_bounds.x) / (m_max_bounds.x - m_min_bounds.x) * (m_res_x - 1);
         float fy = (p.y - m_min_bounds.y) / (m_max_bounds.y - m_min_bounds.y) * (m_res_y - 1);
@@ -802,14 +3099,14 @@ namespace alice2 {
         float tz = fz - z0;
 
         // Get the 8 corner values
-        float c000 = m_field_values[get_index(x0, y0, z0)];
-        float c001 = m_field_values[get_index(x0, y0, z1)];
-        float c010 = m_field_values[get_index(x0, y1, z0)];
-        float c011 = m_field_values[get_index(x0, y1, z1)];
-        float c100 = m_field_values[get_index(x1, y0, z0)];
-        float c101 = m_field_values[get_index(x1, y0, z1)];
-        float c110 = m_field_values[get_index(x1, y1, z0)];
-        float c111 = m_field_values[get_index(x1, y1, z1)];
+        float c000 = values[get_index(x0, y0, z0)];
+        float c001 = values[get_index(x0, y0, z1)];
+        float c010 = values[get_index(x0, y1, z0)];
+        float c011 = values[get_index(x0, y1, z1)];
+        float c100 = values[get_index(x1, y0, z0)];
+        float c101 = values[get_index(x1, y0, z1)];
+        float c110 = values[get_index(x1, y1, z0)];
+        float c111 = values[get_index(x1, y1, z1)];
 
         // Trilinear interpolation
         float c00 = c000 * (1 - tx) + c100 * tx;
@@ -825,13 +3122,157 @@ namespace alice2 {
 
     // Gradient calculation using central differences
     Vec3 ScalarField3D::gradient_at(const Vec3& p) const {
-        float eps = 1.0f;
+        if (m_gradient_cache_enabled) {
+            update_gradient_field();
+            return Vec3(sample_channel(m_gradient_field[0].data(), p),
+                        sample_channel(m_gradient_field[1].data(), p),
+                        sample_channel(m_gradient_field[2].data(), p));
+        }
+
+        // Half a cell: a fixed step blurs features on fine grids and skips cells on coarse ones
+        float eps = 0.5f * std::min({m_grid_step.x, m_grid_step.y, m_grid_step.z});
+        if (eps <= 0.0f) eps = 1.0f;   // flat grid axis
 
         float dx = sample_trilinear(Vec3(p.x + eps, p.y, p.z)) - sample_trilinear(Vec3(p.x - eps, p.y, p.z));
         float dy = sample_trilinear(Vec3(p.x, p.y + eps, p.z)) - sample_trilinear(Vec3(p.x, p.y - eps, p.z));
         float dz = sample_trilinear(Vec3(p.x, p.y, p.z + eps)) - sample_trilinear(Vec3(p.x, p.y, p.z - eps));
 
-        return Vec3(dx, dy, dz) * 0.5f;
+        return Vec3(dx, dy, dz) * (0.5f / eps);
+    }
+
+    void ScalarField3D::set_gradient_cache_enabled(bool enabled) {
+        m_gradient_cache_enabled = enabled;
+        if (!enabled) {
+            for (auto& channel : m_gradient_field) {
+                std::vector<float>().swap(channel);
+            }
+            m_gradient_synced = 0;
+        }
+    }
+
+    const std::array<std::vector<float>, 3>& ScalarField3D::get_gradient_field() const {
+        update_gradient_field();
+        return m_gradient_field;
+    }
+
+    // Central differences at grid points [i0, i1] of row (j, k), one-sided on the grid border.
+    // Rows are contiguous in x, so every channel is a SIMD difference of two shifted row pointers.
+    void ScalarField3D::update_gradient_row(int j, int k, int i0, int i1) const {
+        using namespace simd;
+
+        const Vec3 step = get_cell_size();
+        const float* values = m_field_values.data();
+        const int row = get_index(0, j, k);
+        const int coords[3] = {0, j, k};
+        const int res[3] = {m_res_x, m_res_y, m_res_z};
+        const int strides[3] = {1, m_res_x, m_res_x * m_res_y};
+        const float spacing[3] = {step.x, step.y, step.z};
+
+        auto difference = [](const float* hi, const float* lo, float scale, int n, float* out) {
+            const Float vscale = broadcast(scale);
+            int i = 0;
+            for (; i + WIDTH <= n; i += WIDTH) {
+                store(out + i, (simd::load(hi + i) - simd::load(lo + i)) * vscale);
+            }
+            for (; i < n; ++i) {
+                out[i] = (hi[i] - lo[i]) * scale;
+            }
+        };
+
+        // x: central differences between the border points, then the one-sided ends
+        float* gx = m_gradient_field[0].data() + row;
+        const float inv_x = spacing[0] > 0.0f ? 1.0f / spacing[0] : 0.0f;
+        const int c0 = std::max(i0, 1);
+        const int c1 = std::min(i1, m_res_x - 2);
+        if (c0 <= c1) {
+            difference(values + row + c0 + 1, values + row + c0 - 1, 0.5f * inv_x, c1 - c0 + 1, gx + c0);
+        }
+        if (i0 == 0) {
+            gx[0] = m_res_x > 1 ? (values[row + 1] - values[row]) * inv_x : 0.0f;
+        }
+        if (i1 == m_res_x - 1 && m_res_x > 1) {
+            gx[i1] = (values[row + i1] - values[row + i1 - 1]) * inv_x;
+        }
+
+        // y and z: the whole row segment shares one pair of neighbour rows
+        for (int axis = 1; axis < 3; ++axis) {
+            const bool has_lo = coords[axis] > 0;
+            const bool has_hi = coords[axis] + 1 < res[axis];
+            const int span = static_cast<int>(has_lo) + static_cast<int>(has_hi);
+            const float scale = (span > 0 && spacing[axis] > 0.0f) ? 1.0f / (span * spacing[axis]) : 0.0f;
+            const float* lo = values + row + (has_lo ? -strides[axis] : 0);
+            const float* hi = values + row + (has_hi ? strides[axis] : 0);
+            difference(hi + i0, lo + i0, scale, i1 - i0 + 1, m_gradient_field[axis].data() + row + i0);
+        }
+    }
+
+    // Bring the gradient cache up to the current write version. A full write (or a missing cache)
+    // rebuilds every row; otherwise only the point rows of bricks stamped since the last refresh
+    // are recomputed. A brick's closed point range already holds every point one step away from
+    // its writes, so no extra margin is needed. Safe to call from several threads at once: the
+    // first one to take the lock refreshes, the others wait and then find the cache current.
+    void ScalarField3D::update_gradient_field() const {
+        if (m_gradient_synced.load(std::memory_order_acquire) == m_write_version + 1) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_gradient_mutex);
+        refresh_gradient_field();
+        m_gradient_synced.store(m_write_version + 1, std::memory_order_release);
+    }
+
+    void ScalarField3D::refresh_gradient_field() const {
+        const size_t count = m_field_values.size();
+        const bool full = m_gradient_field[0].size() != count || m_full_write_version > m_gradient_version;
+        if (!full && m_write_version == m_gradient_version) {
+            return;
+        }
+
+        if (full) {
+            for (auto& channel : m_gradient_field) {
+                channel.resize(count);
+            }
+            parallel_for(m_res_z, m_extract_settings.num_threads, [&](int k) {
+                for (int j = 0; j < m_res_y; ++j) {
+                    update_gradient_row(j, k, 0, m_res_x - 1);
+                }
+            });
+            m_gradient_version = m_write_version;
+            return;
+        }
+
+        // Union of stale x-spans per point row
+        const int bricks_x = brick_count(m_res_x);
+        const int bricks_y = brick_count(m_res_y);
+        const int bricks_z = brick_count(m_res_z);
+        std::vector<std::pair<int, int>> spans(static_cast<size_t>(m_res_y) * m_res_z, {m_res_x, -1});
+        std::vector<int> rows;
+        for (int bz = 0; bz < bricks_z; ++bz) {
+            for (int by = 0; by < bricks_y; ++by) {
+                for (int bx = 0; bx < bricks_x; ++bx) {
+                    if (m_brick_versions[(static_cast<size_t>(bz) * bricks_y + by) * bricks_x + bx] <= m_gradient_version) {
+                        continue;
+                    }
+                    const int x0 = bx * BRICK_SIZE;
+                    const int x1 = std::min(m_res_x - 1, x0 + BRICK_SIZE);
+                    for (int k = bz * BRICK_SIZE; k <= std::min(m_res_z - 1, (bz + 1) * BRICK_SIZE); ++k) {
+                        for (int j = by * BRICK_SIZE; j <= std::min(m_res_y - 1, (by + 1) * BRICK_SIZE); ++j) {
+                            auto& span = spans[static_cast<size_t>(k) * m_res_y + j];
+                            if (span.second < 0) {
+                                rows.push_back(k * m_res_y + j);
+                            }
+                            span.first = std::min(span.first, x0);
+                            span.second = std::max(span.second, x1);
+                        }
+                    }
+                }
+            }
+        }
+
+        parallel_for(static_cast<int>(rows.size()), m_extract_settings.num_threads, [&](int n) {
+            const int row = rows[n];
+            update_gradient_row(row % m_res_y, row / m_res_y, spans[row].first, spans[row].second);
+        });
+        m_gradient_version = m_write_version;
     }
 
     float ScalarField3D::value_at(const Vec3& p) const{
@@ -876,14 +3317,211 @@ namespace alice2 {
         return p;
     }
 
+    // Batched queries work through fixed-size blocks so the per-block scratch lives on the stack;
+    // a worker task covers several blocks to keep scheduling overhead low
+    static constexpr int FIELD_BATCH_BLOCK = 256;
+    static constexpr int FIELD_BATCH_TASK = 16 * FIELD_BATCH_BLOCK;
+
+    template <typename BlockFn>
+    static void for_each_batch_block(int count, int num_threads, BlockFn&& fn) {
+        const int tasks = (count + FIELD_BATCH_TASK - 1) / FIELD_BATCH_TASK;
+        parallel_for(tasks, num_threads, [&](int task) {
+            const int end = std::min(count, (task + 1) * FIELD_BATCH_TASK);
+            for (int begin = task * FIELD_BATCH_TASK; begin < end; begin += FIELD_BATCH_BLOCK) {
+                fn(begin, std::min(FIELD_BATCH_BLOCK, end - begin));
+            }
+        });
+    }
+
+    // Same arithmetic as sample_channel, simd::WIDTH points at a time; the eight corners are
+    // gathered from the base index with constant offsets. Leftover points take the scalar path.
+    void ScalarField3D::sample_trilinear_block(const float* values, const float* xs, const float* ys, const float* zs,
+                                               int n, float* out) const {
+        using namespace simd;
+
+        const int stride_y = m_res_x;
+        const int stride_z = m_res_x * m_res_y;
+
+        const Float min_x = broadcast(m_min_bounds.x);
+        const Float min_y = broadcast(m_min_bounds.y);
+        const Float min_z = broadcast(m_min_bounds.z);
+        const Float extent_x = broadcast(m_max_bounds.x - m_min_bounds.x);
+        const Float extent_y = broadcast(m_max_bounds.y - m_min_bounds.y);
+        const Float extent_z = broadcast(m_max_bounds.z - m_min_bounds.z);
+        const Float scale_x = broadcast(static_cast<float>(m_res_x - 1));
+        const Float scale_y = broadcast(static_cast<float>(m_res_y - 1));
+        const Float scale_z = broadcast(static_cast<float>(m_res_z - 1));
+        const Float one = broadcast(1.0f);
+
+        int i = 0;
+        for (; i + WIDTH <= n; i += WIDTH) {
+            const Float fx = (simd::load(xs + i) - min_x) / extent_x * scale_x;
+            const Float fy = (simd::load(ys + i) - min_y) / extent_y * scale_y;
+            const Float fz = (simd::load(zs + i) - min_z) / extent_z * scale_z;
+
+            const Int x0 = floor_clamped(fx, 0, m_res_x - 2);
+            const Int y0 = floor_clamped(fy, 0, m_res_y - 2);
+            const Int z0 = floor_clamped(fz, 0, m_res_z - 2);
+
+            const Float tx = fx - to_float(x0);
+            const Float ty = fy - to_float(y0);
+            const Float tz = fz - to_float(z0);
+
+            const Int base = linear_index(x0, y0, z0, stride_y, stride_z);
+            const Float c000 = gather(values, base);
+            const Float c001 = gather(values + stride_z, base);
+            const Float c010 = gather(values + stride_y, base);
+            const Float c011 = gather(values + stride_y + stride_z, base);
+            const Float c100 = gather(values + 1, base);
+            const Float c101 = gather(values + 1 + stride_z, base);
+            const Float c110 = gather(values + 1 + stride_y, base);
+            const Float c111 = gather(values + 1 + stride_y + stride_z, base);
+
+            const Float c00 = c000 * (one - tx) + c100 * tx;
+            const Float c01 = c001 * (one - tx) + c101 * tx;
+            const Float c10 = c010 * (one - tx) + c110 * tx;
+            const Float c11 = c011 * (one - tx) + c111 * tx;
+
+            const Float c0 = c00 * (one - ty) + c10 * ty;
+            const Float c1 = c01 * (one - ty) + c11 * ty;
+
+            store(out + i, c0 * (one - tz) + c1 * tz);
+        }
+
+        for (; i < n; ++i) {
+            out[i] = sample_channel(values, Vec3(xs[i], ys[i], zs[i]));
+        }
+    }
+
+    // Central differences as in gradient_at, one axis at a time over the whole block; with the
+    // gradient cache enabled (and refreshed by the caller) the cached channels are interpolated
+    void ScalarField3D::gradient_block(const float* xs, const float* ys, const float* zs, int n,
+                                       float* gx, float* gy, float* gz) const {
+        if (m_gradient_cache_enabled) {
+            sample_trilinear_block(m_gradient_field[0].data(), xs, ys, zs, n, gx);
+            sample_trilinear_block(m_gradient_field[1].data(), xs, ys, zs, n, gy);
+            sample_trilinear_block(m_gradient_field[2].data(), xs, ys, zs, n, gz);
+            return;
+        }
+
+        float eps = 0.5f * std::min({m_grid_step.x, m_grid_step.y, m_grid_step.z});
+        if (eps <= 0.0f) eps = 1.0f;   // flat grid axis
+        const float scale = 0.5f / eps;
+
+        float shifted[FIELD_BATCH_BLOCK];
+        float plus[FIELD_BATCH_BLOCK];
+        float minus[FIELD_BATCH_BLOCK];
+
+        const float* coords[3] = {xs, ys, zs};
+        float* gradient[3] = {gx, gy, gz};
+        for (int axis = 0; axis < 3; ++axis) {
+            const float* source = coords[axis];
+            const float* sample[3] = {xs, ys, zs};
+            sample[axis] = shifted;
+
+            for (int i = 0; i < n; ++i) shifted[i] = source[i] + eps;
+            sample_trilinear_block(m_field_values.data(), sample[0], sample[1], sample[2], n, plus);
+            for (int i = 0; i < n; ++i) shifted[i] = source[i] - eps;
+            sample_trilinear_block(m_field_values.data(), sample[0], sample[1], sample[2], n, minus);
+
+            for (int i = 0; i < n; ++i) {
+                gradient[axis][i] = (plus[i] - minus[i]) * scale;
+            }
+        }
+    }
+
+    // Newton steps as in project_onto_isosurface. Points that converge or hit a flat gradient drop
+    // out of the active list, so later iterations only sample the stragglers.
+    void ScalarField3D::project_block(float* xs, float* ys, float* zs, int n, float isoLevel, int maxIterations,
+                                      float tolerance) const {
+        int active[FIELD_BATCH_BLOCK];
+        float px[FIELD_BATCH_BLOCK];
+        float py[FIELD_BATCH_BLOCK];
+        float pz[FIELD_BATCH_BLOCK];
+        float diff[FIELD_BATCH_BLOCK];
+        float gx[FIELD_BATCH_BLOCK];
+        float gy[FIELD_BATCH_BLOCK];
+        float gz[FIELD_BATCH_BLOCK];
+
+        for (int i = 0; i < n; ++i) {
+            xs[i] = std::clamp(xs[i], m_min_bounds.x, m_max_bounds.x);
+            ys[i] = std::clamp(ys[i], m_min_bounds.y, m_max_bounds.y);
+            zs[i] = std::clamp(zs[i], m_min_bounds.z, m_max_bounds.z);
+            active[i] = i;
+        }
+
+        int active_count = n;
+        for (int iteration = 0; iteration < maxIterations && active_count > 0; ++iteration) {
+            for (int a = 0; a < active_count; ++a) {
+                px[a] = xs[active[a]];
+                py[a] = ys[active[a]];
+                pz[a] = zs[active[a]];
+            }
+            sample_trilinear_block(m_field_values.data(), px, py, pz, active_count, diff);
+
+            int off_surface = 0;
+            for (int a = 0; a < active_count; ++a) {
+                const float d = diff[a] - isoLevel;
+                if (std::abs(d) <= tolerance) continue;
+                active[off_surface] = active[a];
+                px[off_surface] = px[a];
+                py[off_surface] = py[a];
+                pz[off_surface] = pz[a];
+                diff[off_surface] = d;
+                ++off_surface;
+            }
+            gradient_block(px, py, pz, off_surface, gx, gy, gz);
+
+            active_count = 0;
+            for (int a = 0; a < off_surface; ++a) {
+                const float gradLenSq = gx[a] * gx[a] + gy[a] * gy[a] + gz[a] * gz[a];
+                if (gradLenSq < 1e-8f) continue;
+                const float step = diff[a] / gradLenSq;
+                const int i = active[a];
+                xs[i] = std::clamp(px[a] - gx[a] * step, m_min_bounds.x, m_max_bounds.x);
+                ys[i] = std::clamp(py[a] - gy[a] * step, m_min_bounds.y, m_max_bounds.y);
+                zs[i] = std::clamp(pz[a] - gz[a] * step, m_min_bounds.z, m_max_bounds.z);
+                active[active_count++] = i;
+            }
+        }
+    }
+
+    void ScalarField3D::sample_trilinear_batch(const float* xs, const float* ys, const float* zs, int count,
+                                               float* out, int num_threads) const {
+        for_each_batch_block(count, num_threads, [&](int begin, int n) {
+            sample_trilinear_block(m_field_values.data(), xs + begin, ys + begin, zs + begin, n, out + begin);
+        });
+    }
+
+    void ScalarField3D::gradient_batch(const float* xs, const float* ys, const float* zs, int count,
+                                       float* gx, float* gy, float* gz, int num_threads) const {
+        if (m_gradient_cache_enabled) {
+            update_gradient_field();
+        }
+        for_each_batch_block(count, num_threads, [&](int begin, int n) {
+            gradient_block(xs + begin, ys + begin, zs + begin, n, gx + begin, gy + begin, gz + begin);
+        });
+    }
+
+    void ScalarField3D::project_onto_isosurface_batch(float* xs, float* ys, float* zs, int count, float isoLevel,
+                                                      int maxIterations, float tolerance, int num_threads) const {
+        if (m_gradient_cache_enabled) {
+            update_gradient_field();
+        }
+        for_each_batch_block(count, num_threads, [&](int begin, int n) {
+            project_block(xs + begin, ys + begin, zs + begin, n, isoLevel, maxIterations, tolerance);
+        });
+    }
+
     // Rendering methods
     void ScalarField3D::draw_points(Renderer& renderer, int step) const {
+        normalize_field();
         for (int k = 0; k < m_res_z; k += step) {
             for (int j = 0; j < m_res_y; j += step) {
                 for (int i = 0; i < m_res_x; i += step) {
                     int idx = get_index(i, j, k);
-                    const Vec3& pos = m_grid_points[idx];
-                    float value = m_normalized_values[idx];
+                    const Vec3 pos = grid_point(i, j, k);
+                    float value = (m_field_values[idx] - m_normalized_min) * m_normalized_scale;
 
                     // Color based on field value
                     Color color = Color::lerp(Color(0, 0, 1), Color(1, 0, 0), value);
@@ -899,7 +3537,7 @@ namespace alice2 {
             for (int j = 0; j < m_res_y; j += step) {
                 for (int i = 0; i < m_res_x; i += step) {
                     int idx = get_index(i, j, k);
-                    const Vec3& pos = m_grid_points[idx];
+                    const Vec3 pos = grid_point(i, j, k);
                     float value = m_field_values[idx];
 
                     std::string text = std::to_string(static_cast<int>(value * 100) / 100.0f);
@@ -911,12 +3549,13 @@ namespace alice2 {
 
     void ScalarField3D::draw_slice(Renderer& renderer, int z_slice, float point_size) const {
         if (z_slice < 0 || z_slice >= m_res_z) return;
+        normalize_field();
 
         for (int j = 0; j < m_res_y; ++j) {
             for (int i = 0; i < m_res_x; ++i) {
                 int idx = get_index(i, j, z_slice);
-                const Vec3& pos = m_grid_points[idx];
-                float value = m_normalized_values[idx];
+                const Vec3 pos = grid_point(i, j, z_slice);
+                float value = (m_field_values[idx] - m_normalized_min) * m_normalized_scale;
 
                 // Color based on field value
                 Color color = Color::lerp(Color(0, 0, 1), Color(1, 0, 0), value);
@@ -942,8 +3581,140 @@ namespace alice2 {
         return 0.0f; // Simple stub
     }
 
+    // Index offsets of the eight cell corners (standard vertex order) from the cell origin
+    void ScalarField3D::cell_corner_offsets(int offsets[8]) const {
+        for (int c = 0; c < 8; ++c) {
+            offsets[c] = MC_CORNER_OFFSETS[c][0] + MC_CORNER_OFFSETS[c][1] * m_res_x
+                       + MC_CORNER_OFFSETS[c][2] * m_res_x * m_res_y;
+        }
+    }
+
+    // Central-difference gradient at grid point (x, y, z), one-sided on the grid border
+    Vec3 ScalarField3D::grid_gradient(int x, int y, int z) const {
+        const int coords[3] = {x, y, z};
+        const int res[3] = {m_res_x, m_res_y, m_res_z};
+        const int strides[3] = {1, m_res_x, m_res_x * m_res_y};
+        const float spacing[3] = {m_grid_step.x, m_grid_step.y, m_grid_step.z};
+        const int idx = get_index(x, y, z);
+
+        float gradient[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const bool has_lo = coords[axis] > 0;
+            const bool has_hi = coords[axis] + 1 < res[axis];
+            const int span = static_cast<int>(has_lo) + static_cast<int>(has_hi);
+            if (span == 0 || spacing[axis] <= 0.0f) {
+                gradient[axis] = 0.0f;
+                continue;
+            }
+            const float hi = m_field_values[idx + (has_hi ? strides[axis] : 0)];
+            const float lo = m_field_values[idx - (has_lo ? strides[axis] : 0)];
+            gradient[axis] = (hi - lo) / (span * spacing[axis]);
+        }
+        return Vec3(gradient[0], gradient[1], gradient[2]);
+    }
+
+    // Strided variant of polygonize_cell for cell (i, j, k): corner values are read straight from
+    // the field, corner positions are built only for the corners of crossed edges, and triangles
+    // are written to out (room for five). Classification, interpolation, the quality filters and
+    // the winding fix-up follow polygonize_cell exactly, so both produce identical triangles.
+    // With gradient_normals, each crossing also gets the normalized blend of its two corner
+    // gradients, weighted like the position.
+    int ScalarField3D::polygonize_cell_strided(const int offsets[8], int i, int j, int k, float isolevel,
+                                               MCTriangle* out) const {
+        const int base = get_index(i, j, k);
+        float values[8];
+        int cubeindex = 0;
+        bool has_zero_vertices = false;
+        for (int c = 0; c < 8; ++c) {
+            values[c] = m_field_values[base + offsets[c]];
+            const float diff = values[c] - isolevel;
+            if (diff >= -1e-6f) cubeindex |= 1 << c;
+            if (std::abs(diff) <= 1e-6f) has_zero_vertices = true;
+        }
+
+        const int edges = MC_CASES.edge_mask[cubeindex];
+        if (edges == 0) return 0;
+
+        Vec3 corners[8];
+        int corners_ready = 0;
+        auto corner = [&](int c) -> const Vec3& {
+            if (!(corners_ready & (1 << c))) {
+                corners[c] = grid_point(i + MC_CORNER_OFFSETS[c][0], j + MC_CORNER_OFFSETS[c][1], k + MC_CORNER_OFFSETS[c][2]);
+                corners_ready |= 1 << c;
+            }
+            return corners[c];
+        };
+
+        const bool smooth_normals = m_extract_settings.gradient_normals;
+        Vec3 gradients[8];
+        int gradients_ready = 0;
+        auto corner_gradient = [&](int c) -> const Vec3& {
+            if (!(gradients_ready & (1 << c))) {
+                gradients[c] = grid_gradient(i + MC_CORNER_OFFSETS[c][0], j + MC_CORNER_OFFSETS[c][1], k + MC_CORNER_OFFSETS[c][2]);
+                gradients_ready |= 1 << c;
+            }
+            return gradients[c];
+        };
+
+        Vec3 vertlist[12];
+        Vec3 normlist[12];
+        for (int e = 0; e < 12; ++e) {
+            if (!(edges & (1 << e))) continue;
+            const int a = MC_CELL_EDGE_CORNERS[e][0];
+            const int b = MC_CELL_EDGE_CORNERS[e][1];
+            vertlist[e] = vertex_interpolate_robust(isolevel, corner(a), corner(b), values[a], values[b]);
+            if (smooth_normals) {
+                // Same weight as vertex_interpolate_robust, including its snapping cases
+                float mu = 0.5f;
+                if (std::abs(isolevel - values[a]) < 1e-6f) mu = 0.0f;
+                else if (std::abs(isolevel - values[b]) < 1e-6f) mu = 1.0f;
+                else if (std::abs(values[b] - values[a]) >= 1e-6f) mu = std::clamp((isolevel - values[a]) / (values[b] - values[a]), 0.0f, 1.0f);
+
+                const Vec3 gradient = corner_gradient(a) + (corner_gradient(b) - corner_gradient(a)) * mu;
+                const float length = gradient.length();
+                normlist[e] = length > 1e-12f ? gradient / length : Vec3(0, 0, 0);
+            }
+        }
+
+        int ntriang = 0;
+        const uint8_t* list = MC_CASES.edges[cubeindex];
+        for (int t = 0; t < MC_CASES.triangle_count[cubeindex]; ++t) {
+            MCTriangle& triangle = out[ntriang];
+            triangle.vertices[0] = vertlist[list[3 * t]];
+            triangle.vertices[1] = vertlist[list[3 * t + 1]];
+            triangle.vertices[2] = vertlist[list[3 * t + 2]];
+
+            // is_triangle_degenerate and validate_triangle_quality on one cross product
+            const Vec3 v1 = triangle.vertices[1] - triangle.vertices[0];
+            const Vec3 v2 = triangle.vertices[2] - triangle.vertices[0];
+            const Vec3 cross = v1.cross(v2);
+            const float length = cross.length();
+            if (length < 1e-6f) continue;
+            const float area = length * 0.5f;
+            if (area < 1e-8f) continue;
+            const float max_edge = std::max({v1.length(), v2.length(), (triangle.vertices[2] - triangle.vertices[1]).length()});
+            if (max_edge > 0.0f && area / (max_edge * max_edge) < 1e-6f) continue;
+
+            triangle.normal = cross / length;
+            for (int v = 0; v < 3; ++v) {
+                triangle.vertex_normals[v] = smooth_normals ? normlist[list[3 * t + v]] : Vec3(0, 0, 0);
+            }
+            if (has_zero_vertices) {
+                Vec3 cell_center = (corner(0) + corner(1) + corner(2) + corner(3) +
+                                    corner(4) + corner(5) + corner(6) + corner(7)) * 0.125f;
+                Vec3 triangle_center = (triangle.vertices[0] + triangle.vertices[1] + triangle.vertices[2]) / 3.0f;
+                if (triangle.normal.dot(cell_center - triangle_center) > 0.0f) {
+                    std::swap(triangle.vertices[1], triangle.vertices[2]);
+                    std::swap(triangle.vertex_normals[1], triangle.vertex_normals[2]);
+                }
+            }
+            ntriang++;
+        }
+        return ntriang;
+    }
+
     // Enhanced marching cubes polygonize cell implementation with robust vertex classification
-    int ScalarField3D::polygonize_cell(const GridCell& cell, float isolevel, std::vector<MCTriangle>& triangles) const {
+    int ScalarField3D::polygonize_cell(const GridCell& cell, float isolevel, std::vector<MCTriangle>& triangles) {
         int cubeindex = 0;
         Vec3 vertlist[12];
 
@@ -3,18 +3,29 @@
 #ifndef ALICE2_SCALAR_FIELD_3D_H
 #define ALICE2_SCALAR_FIELD_3D_H
 
+#include <array>
+#include <atomic>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <cstdint>
+#include <unordered_map>
 #include <stdexcept>
 #include <algorithm>
 #include <cmath>
 #include "../utils/Math.h"
+#include "FieldFile.h"
 
 namespace alice2 {
 
     // Forward declarations
     class Renderer;
     struct MeshData;
+    struct MCMeshSlab;
+    struct MCBrickMask;
+    struct MCOctree;
+    class SdfExpression;
 
     // Marching cubes lookup tables (defined in cpp file)
     extern const int EDGE_TABLE[256];
@@ -38,8 +49,116 @@ namespace alice2 {
     struct MCTriangle {
         Vec3 vertices[3];
         Vec3 normal;
+        Vec3 vertex_normals[3];     // unit field gradients at the vertices; zero when not computed
         
-        MCTriangle() : normal(0, 0, 1) {}
+        MCTriangle() : normal(0, 0, 1), vertex_normals{Vec3(0, 0, 0), Vec3(0, 0, 0), Vec3(0, 0, 0)} {}
+    };
+
+    // Threading options for isosurface extraction
+    struct MCExtractSettings {
+        int num_threads = 0;        // 0 = hardware concurrency, 1 = serial
+        bool deterministic = true;  // merge z-slabs in order so output matches the serial path byte for byte
+        bool legacy_kernel = false; // polygonize through GridCell copies (reference path for benchmarks)
+        bool gradient_normals = true;   // soup extraction fills MCTriangle::vertex_normals from the field gradient
+    };
+
+    // Dual extraction variants: one vertex per active cell, one quad per crossed grid edge
+    enum class DualMeshMode {
+        SurfaceNets,        // vertex at the mean of the cell's edge crossings
+        DualContouring      // vertex minimizing the QEF of crossing tangent planes (keeps sharp features)
+    };
+
+    // Refinement controls for adaptive (octree) extraction
+    struct AdaptiveMeshSettings {
+        int max_leaf_cells = 16;            // largest leaf edge in cells (power of two)
+        float max_error = 0.05f;            // largest |value - trilinear fit| a coarse leaf may have
+        Vec3 focus_point = Vec3(0, 0, 0);   // e.g. the camera position
+        float focus_distance = 0.0f;        // > 0: a leaf of 2^n cells must be n * focus_distance from the focus
+        DualMeshMode mode = DualMeshMode::DualContouring;
+    };
+
+    // Shapes and combine rules for bounded-support splatting (apply_primitive / apply_primitives)
+    enum class PrimitiveShape {
+        Sphere,     // radius
+        Box,        // half_size
+        Torus       // radius (major) and minor_radius, ring in the XY plane
+    };
+
+    enum class PrimitiveBlend {
+        Min,        // value = min(value, sdf)
+        SmoothMin,  // value = smin(value, sdf, smoothing), same rule as boolean_smin
+        Add         // value += weight * kernel(sdf): 1 inside, smooth falloff to 0 at sdf = falloff
+    };
+
+    // One primitive affects only grid points inside its bounding box grown by falloff. For Min and
+    // SmoothMin the falloff should cover the band the isosurface needs (a few times smoothing for
+    // SmoothMin); values further away keep whatever was there, e.g. the value passed to clear_field.
+    struct FieldPrimitive {
+        PrimitiveShape shape = PrimitiveShape::Sphere;
+        PrimitiveBlend blend = PrimitiveBlend::Min;
+        Vec3 center = Vec3(0, 0, 0);
+        Vec3 half_size = Vec3(1, 1, 1);
+        float radius = 1.0f;
+        float minor_radius = 0.25f;
+        float falloff = 1.0f;
+        float smoothing = 0.5f;
+        float weight = -1.0f;       // Add: negative weights pull values below the isolevel (metaballs)
+    };
+
+    // Value range of one brick of cells, including the corner points shared with its neighbours
+    struct FieldBrick {
+        float min_value = 0.0f;
+        float max_value = 0.0f;
+    };
+
+    // State kept between incremental extractions: the mesh being patched in place and, per brick,
+    // the field version it was polygonized at and the faces it produced. Vertices are shared
+    // through a grid-edge map; unreferenced vertex slots are recycled and compacted occasionally.
+    struct MCIncrementalMesh {
+        std::shared_ptr<MeshData> mesh;
+        float isolevel = 0.0f;
+        std::vector<uint64_t> brick_versions;           // version each brick was last polygonized at
+        std::vector<std::vector<int>> brick_faces;      // faces produced by each brick
+        std::vector<int> face_bricks;                   // brick of each face
+        std::vector<int> face_slots;                    // position of each face in its brick's list
+        std::vector<int> vertex_refs;                   // faces referencing each vertex (0 = free slot)
+        std::vector<Vec3> normal_sums;                  // area-weighted normal sum per vertex
+        std::vector<uint64_t> vertex_edges;             // grid edge of each vertex (FREE_EDGE if unused)
+        std::unordered_map<uint64_t, int> edge_vertices;
+        std::vector<int> free_vertices;
+        int last_dirty_bricks = 0;                      // bricks re-polygonized by the last update
+
+        static constexpr uint64_t FREE_EDGE = ~uint64_t(0);
+    };
+
+    // Work allowed per progressive extraction call; a limit of 0 is ignored.
+    // At least one row of cells is processed per call, whatever the budget.
+    struct MCExtractBudget {
+        float time_ms = 8.0f;
+        int max_cells = 0;
+    };
+
+    // Resumable coarse-to-fine extraction. Each level polygonizes the field with a coarser cell
+    // stride; mesh shows the last completed level (or the first level while it is still growing)
+    // and is replaced when the next level completes. A write to the field or a new isolevel
+    // restarts the build while keeping the old mesh on screen; cancel() drops everything.
+    struct MCProgressiveMesh {
+        std::shared_ptr<MeshData> mesh;
+        int completed_stride = 0;                       // cell stride of mesh, 0 while still partial
+        bool finished = false;                          // full resolution mesh is complete
+
+        void cancel() { *this = MCProgressiveMesh(); }
+
+        // Build cursor
+        bool started = false;
+        float isolevel = 0.0f;
+        uint64_t field_version = 0;
+        int level = 0;
+        int next_j = 0;
+        int next_k = 0;
+        std::shared_ptr<MeshData> building;
+        std::vector<Vec3> normal_sums;
+        std::unordered_map<uint64_t, int> edge_vertices;
     };
 
     /**
@@ -48,6 +167,10 @@ namespace alice2 {
      * Follows established codebase patterns from ScalarField2D
      */
     class ScalarField3D {
+        friend class SparseScalarField3D;
+        friend class TiledScalarField3D;
+        friend class CompactScalarField3D;
+
     private:
         // Grid properties
         Vec3 m_min_bounds;
@@ -56,10 +179,41 @@ namespace alice2 {
         int m_res_y;
         int m_res_z;
 
+        // Grid point spacing; positions are computed from bounds on the fly
+        Vec3 m_grid_step;
+
         // Dynamic data storage
-        std::vector<Vec3> m_grid_points;
+        std::vector<Vec3> m_custom_points;              // explicit positions from set_points(), normally empty
+        mutable std::vector<Vec3> m_points_cache;       // lazily materialized get_points() view
         std::vector<float> m_field_values;
-        std::vector<float> m_normalized_values;
+        mutable float m_normalized_min = 0.0f;          // drawing maps values to (value - min) * scale
+        mutable float m_normalized_scale = 0.0f;
+        mutable bool m_normalized_dirty = true;
+
+        // Extraction options
+        MCExtractSettings m_extract_settings;
+
+        // Min/max summaries of BRICK_SIZE^3 cell blocks, rebuilt lazily after values change
+        static constexpr int BRICK_SIZE = 8;
+        mutable std::vector<FieldBrick> m_bricks;
+        mutable bool m_bricks_dirty = true;
+        mutable uint64_t m_bricks_version = 0;          // write version the summaries reflect
+
+        // Write versions: full-grid writes bump m_full_write_version, regional writes stamp the
+        // bricks they touch; a brick's version is the larger of the two
+        uint64_t m_write_version = 0;
+        uint64_t m_full_write_version = 0;
+        std::vector<uint64_t> m_brick_versions;
+
+        // Optional cached gradient at grid points (x, y, z channels), refreshed lazily from the
+        // write versions: full writes rebuild it, regional writes recompute the stamped bricks.
+        // Refreshes run under m_gradient_mutex so concurrent const readers can trigger them;
+        // m_gradient_synced (write version + 1, 0 = stale) lets current readers skip the lock.
+        bool m_gradient_cache_enabled = false;
+        mutable std::array<std::vector<float>, 3> m_gradient_field;
+        mutable uint64_t m_gradient_version = 0;        // write version the cache reflects
+        mutable std::atomic<uint64_t> m_gradient_synced{0};
+        mutable std::mutex m_gradient_mutex;
 
         // Helper methods
         inline int get_index(int x, int y, int z) const {
@@ -78,22 +232,84 @@ namespace alice2 {
             return x >= 0 && x < m_res_x && y >= 0 && y < m_res_y && z >= 0 && z < m_res_z;
         }
 
+        // Position of grid point (x, y, z) without bounds checking
+        inline Vec3 grid_point(int x, int y, int z) const {
+            if (!m_custom_points.empty()) {
+                return m_custom_points[get_index(x, y, z)];
+            }
+            return Vec3(m_min_bounds.x + x * m_grid_step.x,
+                        m_min_bounds.y + y * m_grid_step.y,
+                        m_min_bounds.z + z * m_grid_step.z);
+        }
+
         bool is_inside_bounds(const Vec3& p) const;
         Vec3 clamp_to_bounds(const Vec3& p) const;
         void initialize_grid();
-        void normalize_field();
+        void normalize_field() const;
+        void on_values_changed();
+        void on_region_changed(int x0, int y0, int z0, int x1, int y1, int z1);
+        void restamp_versions(uint64_t version, bool bricks_current, bool gradient_current);
+        bool primitive_range(const FieldPrimitive& primitive, int lo[3], int hi[3]) const;
+        void splat_primitive(const FieldPrimitive& primitive, const int lo[3], const int hi[3]);
 
-        // Marching cubes helper methods
-        alice2::VertexClass classify_vertex(float value, float isolevel, float tolerance = 1e-6f) const;
-        Vec3 vertex_interpolate(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2) const;
-        Vec3 vertex_interpolate_robust(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2) const;
+        // Brick summaries
+        inline int brick_count(int resolution) const {
+            return std::max(1, (resolution - 2) / BRICK_SIZE + 1);
+        }
+        inline uint64_t brick_version(size_t brick) const {
+            return std::max(m_brick_versions[brick], m_full_write_version);
+        }
+        void update_bricks() const;
+        void update_brick(int bx, int by, int bz) const;
+        void polygonize_brick(MCIncrementalMesh& state, float isolevel, int bx, int by, int bz,
+                              std::vector<int>& touched) const;
+        void build_brick_mask(float isolevel, MCBrickMask& mask) const;
+        void build_brick_mask(std::span<const float> sorted_isolevels, MCBrickMask& mask) const;
+        static std::pair<size_t, size_t> crossing_levels(std::span<const float> sorted_isolevels,
+                                                         float min_value, float max_value);
+        float sample_channel(const float* values, const Vec3& p) const;
+        void update_gradient_field() const;
+        void refresh_gradient_field() const;
+        void update_gradient_row(int j, int k, int i0, int i1) const;
+        void sample_trilinear_block(const float* values, const float* xs, const float* ys, const float* zs, int n,
+                                    float* out) const;
+        void gradient_block(const float* xs, const float* ys, const float* zs, int n,
+                            float* gx, float* gy, float* gz) const;
+        void project_block(float* xs, float* ys, float* zs, int n, float isoLevel, int maxIterations,
+                           float tolerance) const;
+        int polygonize_progressive_row(MCProgressiveMesh& state, const MCBrickMask& mask, int stride, int j, int k) const;
+
+        // Marching cubes helper methods (static so SparseScalarField3D shares the cell kernel)
+        static alice2::VertexClass classify_vertex(float value, float isolevel, float tolerance = 1e-6f);
+        static Vec3 vertex_interpolate(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2);
+        static Vec3 vertex_interpolate_robust(float isolevel, const Vec3& p1, const Vec3& p2, float val1, float val2);
         GridCell get_grid_cell(int x, int y, int z) const;
-        int polygonize_cell(const GridCell& cell, float isolevel, std::vector<MCTriangle>& triangles) const;
-        bool is_triangle_degenerate(const MCTriangle& triangle, float tolerance = 1e-6f) const;
-        bool validate_triangle_quality(const MCTriangle& triangle, float min_area = 1e-8f) const;
+        static int polygonize_cell(const GridCell& cell, float isolevel, std::vector<MCTriangle>& triangles);
+        void cell_corner_offsets(int offsets[8]) const;
+        Vec3 grid_gradient(int x, int y, int z) const;
+        int polygonize_cell_strided(const int offsets[8], int i, int j, int k, float isolevel, MCTriangle* out) const;
+        static bool is_triangle_degenerate(const MCTriangle& triangle, float tolerance = 1e-6f);
+        static bool validate_triangle_quality(const MCTriangle& triangle, float min_area = 1e-8f);
         int polygonize_cell_tetra(const GridCell& cell,
                                          float iso,
                                          std::vector<MCTriangle>& tris) const;
+        int extract_slab(float isolevel, int z_begin, int z_end, const MCBrickMask& mask,
+                         std::vector<MCTriangle>& triangles) const;
+        void extract_slab_multi(std::span<const float> sorted_isolevels, int z_begin, int z_end,
+                                const MCBrickMask& mask, std::vector<std::vector<MCTriangle>>& triangles) const;
+        Vec3 place_dual_vertex(const Vec3* crossings, int count, const Vec3& lo, const Vec3& hi,
+                               DualMeshMode mode) const;
+        Vec3 dual_cell_vertex(int i, int j, int k, const float values[8], int edges, float isolevel,
+                              DualMeshMode mode) const;
+        void extract_dual_slab(float isolevel, DualMeshMode mode, int z_begin, int z_end,
+                               const MCBrickMask& mask, MCMeshSlab& slab) const;
+        void region_range(int x0, int y0, int z0, int size, float& min_value, float& max_value) const;
+        bool octree_leaf_fits(int x0, int y0, int z0, int size, float isolevel, float max_error) const;
+        int build_octree_node(MCOctree& tree, float isolevel, const AdaptiveMeshSettings& settings,
+                              int x0, int y0, int z0, int size) const;
+        Vec3 octree_leaf_vertex(int x0, int y0, int z0, int size, float isolevel, DualMeshMode mode) const;
+        void extract_indexed_slab(float isolevel, int z_begin, int z_end, const MCBrickMask& mask,
+                                  MCMeshSlab& slab) const;
 
     public:
         // Constructor with RAII principles
@@ -115,13 +331,18 @@ namespace alice2 {
         ScalarField3D& operator=(ScalarField3D&& other) noexcept;
 
         // Getter/Setter methods
-        const std::vector<Vec3>& get_points() const { return m_grid_points; }
-        const void set_points(std::vector<Vec3>& grid_points) { m_grid_points = grid_points; }
+        const std::vector<Vec3>& get_points() const;
+        void set_points(const std::vector<Vec3>& grid_points);
         const std::vector<float>& get_values() const { return m_field_values; }
-        const void set_values(std::vector<float>& field_values) { m_field_values = field_values; }
+        void set_value(int x, int y, int z, float value);
         void set_values(const std::vector<float>& values);
         std::tuple<int, int, int> get_resolution() const { return {m_res_x, m_res_y, m_res_z}; }
         std::pair<Vec3, Vec3> get_bounds() const { return {m_min_bounds, m_max_bounds}; }
+
+        // Binary persistence (see FieldFile.h). Bounds, resolution and values are stored; explicit
+        // positions from set_points() are not. load() keeps the extraction and cache settings.
+        bool save(const std::string& path, FieldCompression compression = FieldCompression::None) const;
+        bool load(const std::string& path);
         
         Vec3 cell_position(int x, int y, int z) const;
         float sample_nearest(const Vec3& p) const;
@@ -129,12 +350,28 @@ namespace alice2 {
         Vec3 gradient_at(const Vec3& p) const;
         Vec3 gradient_normalized(const Vec3& p) const;
         Vec3 project_onto_isosurface(const Vec3& start, float isoLevel = 0.0f, int maxIterations = 8, float tolerance = 1e-4f) const;
+
+        // Batched variants over SoA point arrays, vectorized with SSE2/AVX2 and split across
+        // num_threads workers (0 = hardware concurrency). Results match the per-point calls
+        // above within float rounding; the projection updates xs/ys/zs in place.
+        void sample_trilinear_batch(const float* xs, const float* ys, const float* zs, int count,
+                                    float* out, int num_threads = 1) const;
+        void gradient_batch(const float* xs, const float* ys, const float* zs, int count,
+                            float* gx, float* gy, float* gz, int num_threads = 1) const;
+        void project_onto_isosurface_batch(float* xs, float* ys, float* zs, int count, float isoLevel = 0.0f,
+                                           int maxIterations = 8, float tolerance = 1e-4f, int num_threads = 1) const;
         Vec3 get_cell_size() const;
+
+        // With the cache enabled, gradient_at and gradient_batch interpolate central differences
+        // precomputed at the grid points instead of differencing four trilinear samples per axis
+        void set_gradient_cache_enabled(bool enabled);
+        bool is_gradient_cache_enabled() const { return m_gradient_cache_enabled; }
+        const std::array<std::vector<float>, 3>& get_gradient_field() const;
         float value_at(const Vec3& p) const;
         bool contains_point(const Vec3& p) const;
 
         // Field generation methods (snake_case naming)
-        void clear_field();
+        void clear_field(float value = 0.0f);
         float get_scalar_sphere(const Vec3& center, float radius) const;
         float get_scalar_box(const Vec3& center, const Vec3& half_size) const;
         float get_scalar_torus(const Vec3& center, float major_radius, float minor_radius) const;
@@ -147,15 +384,49 @@ namespace alice2 {
         void apply_scalar_plane(const Vec3& point, const Vec3& normal);
         void apply_scalar_noise(float frequency = 0.1f, float amplitude = 1.0f);
 
+        // Evaluate a composed SDF expression into the field in one fused pass (replaces all values)
+        void apply_sdf(const SdfExpression& expression);
+        // Re-evaluate the expression only at grid points inside [region_min, region_max]
+        void apply_sdf(const SdfExpression& expression, const Vec3& region_min, const Vec3& region_max);
+
+        // Combine one primitive into the field, touching only the points inside its support
+        void apply_primitive(const FieldPrimitive& primitive);
+        // Splat many primitives in parallel. Primitives are binned to 8^3 point tiles and every tile
+        // applies its list in input order, so the result matches calling apply_primitive in a loop.
+        void apply_primitives(std::span<const FieldPrimitive> primitives);
+
         // Boolean operations (snake_case naming)
         void boolean_union(const ScalarField3D& other);
         void boolean_intersect(const ScalarField3D& other);
         void boolean_subtract(const ScalarField3D& other);
         void boolean_smin(const ScalarField3D& other, float smoothing = 1.0f);
 
+        // Restore a signed distance field (|grad| = 1) around the zero level set by parallel fast
+        // sweeping. band_width > 0 limits the work to tiles near the surface and clamps values to
+        // +/-band_width beyond it; otherwise the whole grid is solved.
+        void redistance(float band_width = 0.0f, int max_iterations = 64);
+
         // Marching cubes mesh generation
         std::shared_ptr<MeshData> generate_mesh(float isolevel = 0.0f) const;
         std::vector<MCTriangle> extract_triangles(float isolevel = 0.0f) const;
+        // One grid pass for several isolevels; result[n] holds the triangles of isolevels[n]
+        std::vector<std::vector<MCTriangle>> extract_triangles_multi(std::span<const float> isolevels) const;
+        std::vector<std::shared_ptr<MeshData>> generate_mesh_multi(std::span<const float> isolevels) const;
+        std::shared_ptr<MeshData> generate_mesh_indexed(float isolevel = 0.0f) const;
+        // Quad mesh from surface nets or dual contouring, sharing the slab/brick machinery of the MC path
+        std::shared_ptr<MeshData> generate_mesh_dual(float isolevel = 0.0f,
+                                                     DualMeshMode mode = DualMeshMode::SurfaceNets) const;
+        // Dual mesh over an octree: large leaves where the field is close to trilinear and far from
+        // the focus, full resolution elsewhere; faces are built on shared octree edges, so no cracks
+        std::shared_ptr<MeshData> generate_mesh_adaptive(float isolevel = 0.0f,
+                                                         const AdaptiveMeshSettings& settings = AdaptiveMeshSettings()) const;
+        // Patch state.mesh in place, re-polygonizing only bricks written since the last call
+        std::shared_ptr<MeshData> update_mesh_incremental(MCIncrementalMesh& state, float isolevel = 0.0f) const;
+        // Advance a coarse-to-fine build within the budget; returns true once the full resolution mesh is done
+        bool extract_progressive(MCProgressiveMesh& state, float isolevel = 0.0f,
+                                 const MCExtractBudget& budget = MCExtractBudget()) const;
+        void set_extract_settings(const MCExtractSettings& settings) { m_extract_settings = settings; }
+        const MCExtractSettings& get_extract_settings() const { return m_extract_settings; }
 
         // Rendering methods
         void draw_points(Renderer& renderer, int step = 4) const;
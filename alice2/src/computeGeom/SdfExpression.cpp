@@ -0,0 +1,196 @@
+#include "SdfExpression.h"
+#include <algorithm>
+#include <cmath>
+
+namespace alice2 {
+
+    SdfExpression SdfExpression::primitive(const SdfInstruction& instruction) {
+        SdfExpression expression;
+        expression.m_program.push_back(instruction);
+        expression.m_stack_depth = 1;
+        return expression;
+    }
+
+    SdfExpression SdfExpression::sphere(const Vec3& center, float radius) {
+        return primitive({SdfOp::Sphere, center, Vec3(), radius, 0.0f});
+    }
+
+    SdfExpression SdfExpression::circle(const Vec3& center, float radius) {
+        return primitive({SdfOp::Circle, center, Vec3(), radius, 0.0f});
+    }
+
+    SdfExpression SdfExpression::box(const Vec3& center, const Vec3& half_size) {
+        return primitive({SdfOp::Box, center, half_size, 0.0f, 0.0f});
+    }
+
+    SdfExpression SdfExpression::rect(const Vec3& center, const Vec3& half_size, float angle_radians) {
+        return primitive({SdfOp::Rect, center, half_size, angle_radians, 0.0f});
+    }
+
+    SdfExpression SdfExpression::torus(const Vec3& center, float major_radius, float minor_radius) {
+        return primitive({SdfOp::Torus, center, Vec3(), major_radius, minor_radius});
+    }
+
+    SdfExpression SdfExpression::plane(const Vec3& point, const Vec3& normal) {
+        return primitive({SdfOp::Plane, point, normal.normalized(), 0.0f, 0.0f});
+    }
+
+    // Postfix concatenation: left operand, right operand, then the operator.
+    // The right operand is evaluated while the left result occupies one stack slot.
+    SdfExpression SdfExpression::combine(const SdfExpression& other, SdfOp op, float s0) const {
+        if (other.empty()) return *this;
+        if (empty()) return other;
+
+        SdfExpression expression;
+        expression.m_program.reserve(m_program.size() + other.m_program.size() + 1);
+        expression.m_program = m_program;
+        expression.m_program.insert(expression.m_program.end(), other.m_program.begin(), other.m_program.end());
+        expression.m_program.push_back({op, Vec3(), Vec3(), s0, 0.0f});
+        expression.m_stack_depth = std::max(m_stack_depth, other.m_stack_depth + 1);
+        return expression;
+    }
+
+    SdfExpression SdfExpression::boolean_union(const SdfExpression& other) const {
+        return combine(other, SdfOp::Union);
+    }
+
+    SdfExpression SdfExpression::boolean_intersect(const SdfExpression& other) const {
+        return combine(other, SdfOp::Intersect);
+    }
+
+    SdfExpression SdfExpression::boolean_subtract(const SdfExpression& other) const {
+        return combine(other, SdfOp::Subtract);
+    }
+
+    SdfExpression SdfExpression::boolean_smin(const SdfExpression& other, float smoothing) const {
+        return combine(other, SdfOp::SmoothMin, smoothing);
+    }
+
+    float SdfExpression::evaluate(const Vec3& p) const {
+        if (empty()) return 0.0f;
+
+        std::vector<float> stack(m_stack_depth * BATCH_SIZE);
+        float result = 0.0f;
+        evaluate_batch(&p.x, &p.y, &p.z, 1, &result, stack.data());
+        return result;
+    }
+
+    void SdfExpression::evaluate(const float* xs, const float* ys, const float* zs, int count,
+                                 float* out, std::vector<float>& scratch) const {
+        if (empty()) {
+            std::fill(out, out + count, 0.0f);
+            return;
+        }
+
+        scratch.resize(static_cast<size_t>(m_stack_depth) * BATCH_SIZE);
+        for (int begin = 0; begin < count; begin += BATCH_SIZE) {
+            const int n = std::min(BATCH_SIZE, count - begin);
+            evaluate_batch(xs + begin, ys + begin, zs + begin, n, out + begin, scratch.data());
+        }
+    }
+
+    // Run the program over n <= BATCH_SIZE points. Stack slot s occupies stack[s * BATCH_SIZE, +n).
+    void SdfExpression::evaluate_batch(const float* xs, const float* ys, const float* zs, int n,
+                                       float* out, float* stack) const {
+        int top = 0;
+        for (const SdfInstruction& ins : m_program) {
+            float* dst = stack + top * BATCH_SIZE;
+
+            switch (ins.op) {
+            case SdfOp::Sphere:
+                for (int i = 0; i < n; ++i) {
+                    const float dx = xs[i] - ins.a.x;
+                    const float dy = ys[i] - ins.a.y;
+                    const float dz = zs[i] - ins.a.z;
+                    dst[i] = std::sqrt(dx * dx + dy * dy + dz * dz) - ins.s0;
+                }
+                ++top;
+                break;
+
+            case SdfOp::Circle:
+                for (int i = 0; i < n; ++i) {
+                    const float dx = xs[i] - ins.a.x;
+                    const float dy = ys[i] - ins.a.y;
+                    dst[i] = std::sqrt(dx * dx + dy * dy) - ins.s0;
+                }
+                ++top;
+                break;
+
+            case SdfOp::Box:
+                for (int i = 0; i < n; ++i) {
+                    const float dx = std::abs(xs[i] - ins.a.x) - ins.b.x;
+                    const float dy = std::abs(ys[i] - ins.a.y) - ins.b.y;
+                    const float dz = std::abs(zs[i] - ins.a.z) - ins.b.z;
+                    const float ox = std::max(dx, 0.0f);
+                    const float oy = std::max(dy, 0.0f);
+                    const float oz = std::max(dz, 0.0f);
+                    dst[i] = std::max(std::max(dx, dy), std::max(dz, 0.0f)) + std::sqrt(ox * ox + oy * oy + oz * oz);
+                }
+                ++top;
+                break;
+
+            case SdfOp::Rect: {
+                const float cos_angle = std::cos(ins.s0);
+                const float sin_angle = std::sin(ins.s0);
+                for (int i = 0; i < n; ++i) {
+                    const float px = xs[i] - ins.a.x;
+                    const float py = ys[i] - ins.a.y;
+                    const float qx = std::abs(cos_angle * px + sin_angle * py);
+                    const float qy = std::abs(-sin_angle * px + cos_angle * py);
+                    const float dx = std::max(qx - ins.b.x, 0.0f);
+                    const float dy = std::max(qy - ins.b.y, 0.0f);
+                    const float outside_dist = std::sqrt(dx * dx + dy * dy);
+                    const float inside_dist = std::min(std::max(qx - ins.b.x, qy - ins.b.y), 0.0f);
+                    dst[i] = (outside_dist > 0.0f) ? outside_dist : inside_dist;
+                }
+                ++top;
+                break;
+            }
+
+            case SdfOp::Torus:
+                for (int i = 0; i < n; ++i) {
+                    const float dx = xs[i] - ins.a.x;
+                    const float dy = ys[i] - ins.a.y;
+                    const float dz = zs[i] - ins.a.z;
+                    const float q = std::sqrt(dx * dx + dy * dy) - ins.s0;
+                    dst[i] = std::sqrt(q * q + dz * dz) - ins.s1;
+                }
+                ++top;
+                break;
+
+            case SdfOp::Plane:
+                for (int i = 0; i < n; ++i) {
+                    dst[i] = (xs[i] - ins.a.x) * ins.b.x + (ys[i] - ins.a.y) * ins.b.y + (zs[i] - ins.a.z) * ins.b.z;
+                }
+                ++top;
+                break;
+
+            case SdfOp::Union:
+            case SdfOp::Intersect:
+            case SdfOp::Subtract:
+            case SdfOp::SmoothMin: {
+                float* lhs = stack + (top - 2) * BATCH_SIZE;
+                const float* rhs = stack + (top - 1) * BATCH_SIZE;
+                if (ins.op == SdfOp::Union) {
+                    for (int i = 0; i < n; ++i) lhs[i] = std::min(lhs[i], rhs[i]);
+                } else if (ins.op == SdfOp::Intersect) {
+                    for (int i = 0; i < n; ++i) lhs[i] = std::max(lhs[i], rhs[i]);
+                } else if (ins.op == SdfOp::Subtract) {
+                    for (int i = 0; i < n; ++i) lhs[i] = std::max(lhs[i], -rhs[i]);
+                } else {
+                    const float k = ins.s0;
+                    for (int i = 0; i < n; ++i) {
+                        const float r = std::exp2(-lhs[i] / k) + std::exp2(-rhs[i] / k);
+                        lhs[i] = -k * std::log2(r);
+                    }
+                }
+                --top;
+                break;
+            }
+            }
+        }
+
+        std::copy(stack, stack + n, out);
+    }
+
+} // namespace alice2
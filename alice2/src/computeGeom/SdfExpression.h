@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef ALICE2_SDF_EXPRESSION_H
+#define ALICE2_SDF_EXPRESSION_H
+
+#include <vector>
+#include "../utils/Math.h"
+
+namespace alice2 {
+
+    // Operation codes of a compiled SDF expression
+    enum class SdfOp {
+        Sphere,         // |p - a| - s0
+        Circle,         // |p.xy - a.xy| - s0
+        Box,            // axis-aligned box at a with half size b (same formula as ScalarField3D::apply_scalar_box)
+        Rect,           // 2D box at a with half size b rotated by s0 (same formula as ScalarField2D::apply_scalar_rect)
+        Torus,          // torus at a in the xy-plane, major radius s0, minor radius s1
+        Plane,          // (p - a) . b with b normalized
+        Union,          // min(l, r)
+        Intersect,      // max(l, r)
+        Subtract,       // max(l, -r)
+        SmoothMin       // -s0 * log2(exp2(-l / s0) + exp2(-r / s0))
+    };
+
+    // One instruction of the postfix program: primitives push a value, operators pop two and push one
+    struct SdfInstruction {
+        SdfOp op;
+        Vec3 a;
+        Vec3 b;
+        float s0 = 0.0f;
+        float s1 = 0.0f;
+    };
+
+    /**
+     * Composable signed distance expression.
+     * Primitives and CSG operators build a tree that is stored directly as a postfix program,
+     * so evaluating it into a field is a single pass over the grid with no intermediate fields.
+     * Points are evaluated in batches; every instruction runs as a tight loop over the batch.
+     */
+    class SdfExpression {
+    public:
+        static constexpr int BATCH_SIZE = 64;
+
+        // Primitives
+        static SdfExpression sphere(const Vec3& center, float radius);
+        static SdfExpression circle(const Vec3& center, float radius);
+        static SdfExpression box(const Vec3& center, const Vec3& half_size);
+        static SdfExpression rect(const Vec3& center, const Vec3& half_size, float angle_radians = 0.0f);
+        static SdfExpression torus(const Vec3& center, float major_radius, float minor_radius);
+        static SdfExpression plane(const Vec3& point, const Vec3& normal);
+
+        // Boolean operations, matching the ScalarField boolean_* semantics
+        SdfExpression boolean_union(const SdfExpression& other) const;
+        SdfExpression boolean_intersect(const SdfExpression& other) const;
+        SdfExpression boolean_subtract(const SdfExpression& other) const;
+        SdfExpression boolean_smin(const SdfExpression& other, float smoothing = 1.0f) const;
+
+        bool empty() const { return m_program.empty(); }
+        const std::vector<SdfInstruction>& get_program() const { return m_program; }
+        int get_stack_depth() const { return m_stack_depth; }
+
+        // Evaluate a single point
+        float evaluate(const Vec3& p) const;
+
+        // Evaluate count points given as coordinate arrays into out.
+        // scratch is reused between calls to avoid reallocating the evaluation stack.
+        void evaluate(const float* xs, const float* ys, const float* zs, int count,
+                      float* out, std::vector<float>& scratch) const;
+
+    private:
+        std::vector<SdfInstruction> m_program;
+        int m_stack_depth = 0;
+
+        static SdfExpression primitive(const SdfInstruction& instruction);
+        SdfExpression combine(const SdfExpression& other, SdfOp op, float s0 = 0.0f) const;
+        void evaluate_batch(const float* xs, const float* ys, const float* zs, int count,
+                            float* out, float* stack) const;
+    };
+
+} // namespace alice2
+
+#endif // ALICE2_SDF_EXPRESSION_H
@@ -0,0 +1,668 @@
+#include "SparseScalarField3D.h"
+#include "SdfExpression.h"
+#include "../objects/MeshObject.h"
+#include "../utils/Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace alice2 {
+
+    namespace {
+        // SDFs built from smooth-min and the box formula may overestimate distance by up to 2x,
+        // so region culling uses a widened margin to avoid dropping leaves near the surface
+        constexpr float CULL_MARGIN = 2.0f;
+        constexpr int BLOCK_DIM = SparseScalarField3D::LEAF_DIM + 2;    // leaf plus one point of halo per side
+
+        inline int region_index(int rx, int ry, int rz) {
+            return ((rz + 1) * 3 + (ry + 1)) * 3 + (rx + 1);
+        }
+    }
+
+    // Constructor
+    SparseScalarField3D::SparseScalarField3D(const Vec3& min_bb, const Vec3& max_bb, int res_x, int res_y, int res_z,
+                                             float band_width)
+        : m_min_bounds(min_bb), m_max_bounds(max_bb), m_res_x(res_x), m_res_y(res_y), m_res_z(res_z) {
+        if (res_x <= 0 || res_y <= 0 || res_z <= 0) {
+            throw std::invalid_argument("Resolution must be positive");
+        }
+
+        m_grid_step = get_cell_size();
+        const float max_step = std::max({m_grid_step.x, m_grid_step.y, m_grid_step.z});
+        m_band_width = band_width > 0.0f ? band_width : 3.0f * max_step;
+    }
+
+    Vec3 SparseScalarField3D::get_cell_size() const {
+        return Vec3(
+            (m_max_bounds.x - m_min_bounds.x) / std::max(1, m_res_x - 1),
+            (m_max_bounds.y - m_min_bounds.y) / std::max(1, m_res_y - 1),
+            (m_max_bounds.z - m_min_bounds.z) / std::max(1, m_res_z - 1)
+        );
+    }
+
+    Vec3 SparseScalarField3D::cell_position(int x, int y, int z) const {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        return grid_point(x, y, z);
+    }
+
+    bool SparseScalarField3D::contains_point(const Vec3& p) const {
+        return p.x >= m_min_bounds.x && p.x <= m_max_bounds.x &&
+               p.y >= m_min_bounds.y && p.y <= m_max_bounds.y &&
+               p.z >= m_min_bounds.z && p.z <= m_max_bounds.z;
+    }
+
+    Vec3 SparseScalarField3D::clamp_to_bounds(const Vec3& p) const {
+        return Vec3(
+            std::clamp(p.x, m_min_bounds.x, m_max_bounds.x),
+            std::clamp(p.y, m_min_bounds.y, m_max_bounds.y),
+            std::clamp(p.z, m_min_bounds.z, m_max_bounds.z)
+        );
+    }
+
+    size_t SparseScalarField3D::get_memory_usage() const {
+        return m_leaves.capacity() * sizeof(Leaf) +
+               m_nodes.capacity() * sizeof(InternalNode) +
+               m_root.size() * (sizeof(uint64_t) + sizeof(int) + 2 * sizeof(void*));
+    }
+
+    // Sparse lookups
+    int SparseScalarField3D::leaf_code(int lx, int ly, int lz) const {
+        if (lx < 0 || ly < 0 || lz < 0) {
+            return TILE_OUTSIDE;
+        }
+        auto it = m_root.find(node_key(lx >> NODE_LOG2, ly >> NODE_LOG2, lz >> NODE_LOG2));
+        if (it == m_root.end()) {
+            return TILE_OUTSIDE;
+        }
+        if (it->second < 0) {
+            return it->second;
+        }
+        return m_nodes[it->second].children[child_slot(lx, ly, lz)];
+    }
+
+    // Slot for leaf (lx, ly, lz), creating its internal node from the root tile if needed
+    int* SparseScalarField3D::leaf_code_slot(int lx, int ly, int lz) {
+        int& root_code = m_root.try_emplace(node_key(lx >> NODE_LOG2, ly >> NODE_LOG2, lz >> NODE_LOG2), TILE_OUTSIDE).first->second;
+        if (root_code < 0) {
+            InternalNode node;
+            std::fill(std::begin(node.children), std::end(node.children), root_code);
+            root_code = static_cast<int>(m_nodes.size());
+            m_nodes.push_back(node);
+        }
+        return &m_nodes[root_code].children[child_slot(lx, ly, lz)];
+    }
+
+    float SparseScalarField3D::get_value(int x, int y, int z) const {
+        const int code = leaf_code(x >> LEAF_LOG2, y >> LEAF_LOG2, z >> LEAF_LOG2);
+        return code < 0 ? tile_value(code) : m_leaves[code].values[leaf_offset(x, y, z)];
+    }
+
+    void SparseScalarField3D::set_value(int x, int y, int z, float value) {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+
+        int* slot = leaf_code_slot(x >> LEAF_LOG2, y >> LEAF_LOG2, z >> LEAF_LOG2);
+        if (*slot < 0) {
+            Leaf leaf;
+            std::fill(std::begin(leaf.values), std::end(leaf.values), tile_value(*slot));
+            *slot = static_cast<int>(m_leaves.size());
+            m_leaves.push_back(leaf);
+        }
+        m_leaves[*slot].values[leaf_offset(x, y, z)] = std::clamp(value, -m_band_width, m_band_width);
+    }
+
+    // A leaf whose values all sit at the band limit on one side is replaced by a tile
+    bool SparseScalarField3D::collapse_leaf(const Leaf& leaf, int& code) const {
+        const auto [min_it, max_it] = std::minmax_element(std::begin(leaf.values), std::end(leaf.values));
+        if (*min_it >= m_band_width) {
+            code = TILE_OUTSIDE;
+            return true;
+        }
+        if (*max_it <= -m_band_width) {
+            code = TILE_INSIDE;
+            return true;
+        }
+        return false;
+    }
+
+    void SparseScalarField3D::clear_field() {
+        m_root.clear();
+        m_nodes.clear();
+        m_leaves.clear();
+    }
+
+    // Build the narrow band from an expression. Internal nodes and leaves whose bounding sphere
+    // lies entirely outside the band become tiles after a single centre evaluation; the
+    // remaining leaves are evaluated densely in parallel and collapsed if they end up constant.
+    void SparseScalarField3D::apply_sdf(const SdfExpression& expression) {
+        clear_field();
+
+        const int leaves_x = leaf_count(m_res_x);
+        const int leaves_y = leaf_count(m_res_y);
+        const int leaves_z = leaf_count(m_res_z);
+
+        // Centre and half extent of the grid points covered by [first, first + count) along one axis
+        auto region_extent = [](int first, int count, int resolution, float step, float origin, float& centre, float& half) {
+            const int last = std::min(first + count - 1, resolution - 1);
+            centre = origin + 0.5f * (first + last) * step;
+            half = 0.5f * (last - first) * step;
+        };
+
+        struct Candidate {
+            int node;
+            int slot;
+            int lx, ly, lz;
+        };
+        std::vector<Candidate> candidates;
+        std::vector<float> xs, ys, zs, distances, scratch;
+
+        const int node_span = NODE_DIM * LEAF_DIM;
+        for (int nz = 0; nz < node_count(m_res_z); ++nz) {
+            for (int ny = 0; ny < node_count(m_res_y); ++ny) {
+                for (int nx = 0; nx < node_count(m_res_x); ++nx) {
+                    Vec3 centre, half;
+                    region_extent(nx * node_span, node_span, m_res_x, m_grid_step.x, m_min_bounds.x, centre.x, half.x);
+                    region_extent(ny * node_span, node_span, m_res_y, m_grid_step.y, m_min_bounds.y, centre.y, half.y);
+                    region_extent(nz * node_span, node_span, m_res_z, m_grid_step.z, m_min_bounds.z, centre.z, half.z);
+
+                    const float d = expression.evaluate(centre);
+                    if (std::abs(d) > m_band_width + CULL_MARGIN * half.length()) {
+                        if (d < 0.0f) {
+                            m_root[node_key(nx, ny, nz)] = TILE_INSIDE;
+                        }
+                        continue;
+                    }
+
+                    // Evaluate all leaf centres of this node in one batch
+                    xs.clear(); ys.clear(); zs.clear();
+                    std::vector<Vec3> halves;
+                    std::vector<int> slots;
+                    for (int cz = 0; cz < NODE_DIM; ++cz) {
+                        const int lz = nz * NODE_DIM + cz;
+                        if (lz >= leaves_z) break;
+                        for (int cy = 0; cy < NODE_DIM; ++cy) {
+                            const int ly = ny * NODE_DIM + cy;
+                            if (ly >= leaves_y) break;
+                            for (int cx = 0; cx < NODE_DIM; ++cx) {
+                                const int lx = nx * NODE_DIM + cx;
+                                if (lx >= leaves_x) break;
+                                Vec3 leaf_centre, leaf_half;
+                                region_extent(lx * LEAF_DIM, LEAF_DIM, m_res_x, m_grid_step.x, m_min_bounds.x, leaf_centre.x, leaf_half.x);
+                                region_extent(ly * LEAF_DIM, LEAF_DIM, m_res_y, m_grid_step.y, m_min_bounds.y, leaf_centre.y, leaf_half.y);
+                                region_extent(lz * LEAF_DIM, LEAF_DIM, m_res_z, m_grid_step.z, m_min_bounds.z, leaf_centre.z, leaf_half.z);
+                                xs.push_back(leaf_centre.x);
+                                ys.push_back(leaf_centre.y);
+                                zs.push_back(leaf_centre.z);
+                                halves.push_back(leaf_half);
+                                slots.push_back(child_slot(lx, ly, lz));
+                            }
+                        }
+                    }
+                    distances.resize(xs.size());
+                    expression.evaluate(xs.data(), ys.data(), zs.data(), static_cast<int>(xs.size()), distances.data(), scratch);
+
+                    InternalNode node;
+                    std::fill(std::begin(node.children), std::end(node.children), TILE_OUTSIDE);
+                    const int node_index = static_cast<int>(m_nodes.size());
+                    bool has_inside = false;
+                    const size_t first_candidate = candidates.size();
+
+                    for (size_t c = 0; c < slots.size(); ++c) {
+                        const int slot = slots[c];
+                        if (std::abs(distances[c]) > m_band_width + CULL_MARGIN * halves[c].length()) {
+                            node.children[slot] = tile_code(distances[c]);
+                            has_inside = has_inside || distances[c] < 0.0f;
+                            continue;
+                        }
+                        const int cx = slot & (NODE_DIM - 1);
+                        const int cy = (slot >> NODE_LOG2) & (NODE_DIM - 1);
+                        const int cz = slot >> (2 * NODE_LOG2);
+                        candidates.push_back({node_index, slot, nx * NODE_DIM + cx, ny * NODE_DIM + cy, nz * NODE_DIM + cz});
+                    }
+
+                    if (candidates.size() == first_candidate && !has_inside) {
+                        continue;   // every leaf is an outside tile
+                    }
+                    m_root[node_key(nx, ny, nz)] = node_index;
+                    m_nodes.push_back(node);
+                }
+            }
+        }
+
+        // Evaluate candidate leaves densely
+        std::vector<Leaf> leaves(candidates.size());
+        std::vector<int> codes(candidates.size(), 0);
+        parallel_for(static_cast<int>(candidates.size()), m_extract_settings.num_threads, [&](int c) {
+            const Candidate& candidate = candidates[c];
+            float px[LEAF_SIZE], py[LEAF_SIZE], pz[LEAF_SIZE];
+            std::vector<float> local_scratch;
+            for (int k = 0; k < LEAF_DIM; ++k) {
+                for (int j = 0; j < LEAF_DIM; ++j) {
+                    for (int i = 0; i < LEAF_DIM; ++i) {
+                        const int offset = (k * LEAF_DIM + j) * LEAF_DIM + i;
+                        const Vec3 pt = grid_point(candidate.lx * LEAF_DIM + i, candidate.ly * LEAF_DIM + j, candidate.lz * LEAF_DIM + k);
+                        px[offset] = pt.x;
+                        py[offset] = pt.y;
+                        pz[offset] = pt.z;
+                    }
+                }
+            }
+
+            Leaf& leaf = leaves[c];
+            expression.evaluate(px, py, pz, LEAF_SIZE, leaf.values, local_scratch);
+            for (float& value : leaf.values) {
+                value = std::clamp(value, -m_band_width, m_band_width);
+            }
+            if (!collapse_leaf(leaf, codes[c])) {
+                codes[c] = 0;
+            }
+        });
+
+        // Keep the leaves that did not collapse
+        m_leaves.reserve(candidates.size());
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            int& slot = m_nodes[candidates[c].node].children[candidates[c].slot];
+            if (codes[c] < 0) {
+                slot = codes[c];
+            } else {
+                slot = static_cast<int>(m_leaves.size());
+                m_leaves.push_back(leaves[c]);
+            }
+        }
+        m_leaves.shrink_to_fit();
+    }
+
+    void SparseScalarField3D::apply_scalar_sphere(const Vec3& center, float radius) {
+        apply_sdf(SdfExpression::sphere(center, radius));
+    }
+
+    void SparseScalarField3D::apply_scalar_box(const Vec3& center, const Vec3& half_size) {
+        apply_sdf(SdfExpression::box(center, half_size));
+    }
+
+    void SparseScalarField3D::apply_scalar_torus(const Vec3& center, float major_radius, float minor_radius) {
+        apply_sdf(SdfExpression::torus(center, major_radius, minor_radius));
+    }
+
+    void SparseScalarField3D::apply_scalar_plane(const Vec3& point, const Vec3& normal) {
+        apply_sdf(SdfExpression::plane(point, normal));
+    }
+
+    // Combine with another field of the same layout. Regions that are tiles in both inputs stay
+    // tiles; every other region is combined value by value into a new leaf, which is dropped again
+    // if the result is constant. Internal nodes are processed in parallel.
+    template <typename CombineFn>
+    void SparseScalarField3D::combine(const SparseScalarField3D& other, CombineFn&& fn) {
+        if (m_res_x != other.m_res_x || m_res_y != other.m_res_y || m_res_z != other.m_res_z) {
+            return; // Skip if sizes don't match
+        }
+
+        std::vector<uint64_t> keys;
+        keys.reserve(m_root.size() + other.m_root.size());
+        for (const auto& entry : m_root) keys.push_back(entry.first);
+        for (const auto& entry : other.m_root) keys.push_back(entry.first);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        auto root_code = [](const SparseScalarField3D& field, uint64_t key) {
+            auto it = field.m_root.find(key);
+            return it == field.m_root.end() ? TILE_OUTSIDE : it->second;
+        };
+
+        struct NodeResult {
+            int code = TILE_OUTSIDE;
+            InternalNode node;
+            std::vector<Leaf> leaves;
+        };
+        std::vector<NodeResult> results(keys.size());
+
+        parallel_for(static_cast<int>(keys.size()), m_extract_settings.num_threads, [&](int n) {
+            const int code_a = root_code(*this, keys[n]);
+            const int code_b = root_code(other, keys[n]);
+            NodeResult& result = results[n];
+
+            if (code_a < 0 && code_b < 0) {
+                result.code = tile_code(fn(tile_value(code_a), other.tile_value(code_b)));
+                return;
+            }
+
+            bool any_leaf = false;
+            bool any_inside = false;
+            for (int slot = 0; slot < NODE_SIZE; ++slot) {
+                const int child_a = code_a < 0 ? code_a : m_nodes[code_a].children[slot];
+                const int child_b = code_b < 0 ? code_b : other.m_nodes[code_b].children[slot];
+
+                if (child_a < 0 && child_b < 0) {
+                    result.node.children[slot] = tile_code(fn(tile_value(child_a), other.tile_value(child_b)));
+                    any_inside = any_inside || result.node.children[slot] == TILE_INSIDE;
+                    continue;
+                }
+
+                Leaf leaf;
+                const Leaf* leaf_a = child_a < 0 ? nullptr : &m_leaves[child_a];
+                const Leaf* leaf_b = child_b < 0 ? nullptr : &other.m_leaves[child_b];
+                const float tile_a = tile_value(child_a);
+                const float tile_b = other.tile_value(child_b);
+                for (int v = 0; v < LEAF_SIZE; ++v) {
+                    const float a = leaf_a ? leaf_a->values[v] : tile_a;
+                    const float b = leaf_b ? leaf_b->values[v] : tile_b;
+                    leaf.values[v] = std::clamp(fn(a, b), -m_band_width, m_band_width);
+                }
+
+                int collapsed = 0;
+                if (collapse_leaf(leaf, collapsed)) {
+                    result.node.children[slot] = collapsed;
+                    any_inside = any_inside || collapsed == TILE_INSIDE;
+                    continue;
+                }
+                result.node.children[slot] = static_cast<int>(result.leaves.size());
+                result.leaves.push_back(leaf);
+                any_leaf = true;
+            }
+
+            result.code = (any_leaf || any_inside) ? 0 : TILE_OUTSIDE;
+        });
+
+        // Merge node results, offsetting leaf indices
+        std::unordered_map<uint64_t, int> root;
+        std::vector<InternalNode> nodes;
+        std::vector<Leaf> leaves;
+        for (size_t n = 0; n < keys.size(); ++n) {
+            NodeResult& result = results[n];
+            if (result.code < 0) {
+                if (result.code == TILE_INSIDE) {
+                    root[keys[n]] = TILE_INSIDE;
+                }
+                continue;
+            }
+            const int leaf_base = static_cast<int>(leaves.size());
+            for (int& child : result.node.children) {
+                if (child >= 0) child += leaf_base;
+            }
+            leaves.insert(leaves.end(), result.leaves.begin(), result.leaves.end());
+            root[keys[n]] = static_cast<int>(nodes.size());
+            nodes.push_back(result.node);
+        }
+
+        m_root = std::move(root);
+        m_nodes = std::move(nodes);
+        m_leaves = std::move(leaves);
+    }
+
+    void SparseScalarField3D::boolean_union(const SparseScalarField3D& other) {
+        combine(other, [](float a, float b) { return std::min(a, b); });
+    }
+
+    void SparseScalarField3D::boolean_intersect(const SparseScalarField3D& other) {
+        combine(other, [](float a, float b) { return std::max(a, b); });
+    }
+
+    void SparseScalarField3D::boolean_subtract(const SparseScalarField3D& other) {
+        combine(other, [](float a, float b) { return std::max(a, -b); });
+    }
+
+    void SparseScalarField3D::boolean_smin(const SparseScalarField3D& other, float smoothing) {
+        combine(other, [smoothing](float a, float b) {
+            float r = std::exp2(-a / smoothing) + std::exp2(-b / smoothing);
+            return -smoothing * std::log2(r);
+        });
+    }
+
+    // Sampling
+    float SparseScalarField3D::sample_trilinear(const Vec3& p) const {
+        // Convert world position to grid coordinates
+        float fx = (p.x - m_min_bounds.x) / (m_max_bounds.x - m_min_bounds.x) * (m_res_x - 1);
+        float fy = (p.y - m_min_bounds.y) / (m_max_bounds.y - m_min_bounds.y) * (m_res_y - 1);
+        float fz = (p.z - m_min_bounds.z) / (m_max_bounds.z - m_min_bounds.z) * (m_res_z - 1);
+
+        int x0 = std::clamp(static_cast<int>(std::floor(fx)), 0, m_res_x - 2);
+        int y0 = std::clamp(static_cast<int>(std::floor(fy)), 0, m_res_y - 2);
+        int z0 = std::clamp(static_cast<int>(std::floor(fz)), 0, m_res_z - 2);
+
+        int x1 = x0 + 1;
+        int y1 = y0 + 1;
+        int z1 = z0 + 1;
+
+        float tx = fx - x0;
+        float ty = fy - y0;
+        float tz = fz - z0;
+
+        float c000 = get_value(x0, y0, z0);
+        float c001 = get_value(x0, y0, z1);
+        float c010 = get_value(x0, y1, z0);
+        float c011 = get_value(x0, y1, z1);
+        float c100 = get_value(x1, y0, z0);
+        float c101 = get_value(x1, y0, z1);
+        float c110 = get_value(x1, y1, z0);
+        float c111 = get_value(x1, y1, z1);
+
+        float c00 = c000 * (1 - tx) + c100 * tx;
+        float c01 = c001 * (1 - tx) + c101 * tx;
+        float c10 = c010 * (1 - tx) + c110 * tx;
+        float c11 = c011 * (1 - tx) + c111 * tx;
+
+        float c0 = c00 * (1 - ty) + c10 * ty;
+        float c1 = c01 * (1 - ty) + c11 * ty;
+
+        return c0 * (1 - tz) + c1 * tz;
+    }
+
+    // Gradient calculation using central differences (same stencil as ScalarField3D)
+    Vec3 SparseScalarField3D::gradient_at(const Vec3& p) const {
+        float eps = 0.5f * std::min({m_grid_step.x, m_grid_step.y, m_grid_step.z});
+        if (eps <= 0.0f) eps = 1.0f;   // flat grid axis
+
+        float dx = sample_trilinear(Vec3(p.x + eps, p.y, p.z)) - sample_trilinear(Vec3(p.x - eps, p.y, p.z));
+        float dy = sample_trilinear(Vec3(p.x, p.y + eps, p.z)) - sample_trilinear(Vec3(p.x, p.y - eps, p.z));
+        float dz = sample_trilinear(Vec3(p.x, p.y, p.z + eps)) - sample_trilinear(Vec3(p.x, p.y, p.z - eps));
+
+        return Vec3(dx, dy, dz) * (0.5f / eps);
+    }
+
+    Vec3 SparseScalarField3D::gradient_normalized(const Vec3& p) const {
+        Vec3 g = gradient_at(p);
+        float len = g.length();
+        if (len <= 1e-6f) {
+            return Vec3(0.0f, 0.0f, 0.0f);
+        }
+        return g * (1.0f / len);
+    }
+
+    float SparseScalarField3D::value_at(const Vec3& p) const {
+        if (m_res_x <= 1 || m_res_y <= 1 || m_res_z <= 1) {
+            return m_band_width;
+        }
+        return sample_trilinear(contains_point(p) ? p : clamp_to_bounds(p));
+    }
+
+    // Values of grid points [o - 1, o + LEAF_DIM] around leaf (lx, ly, lz), where o is the leaf origin.
+    // leaf_neighbours[region_index(rx, ry, rz)] tells whether each of the 27 surrounding regions is a leaf.
+    void SparseScalarField3D::gather_block(int lx, int ly, int lz, float* block, bool* leaf_neighbours) const {
+        int codes[27];
+        for (int rz = -1; rz <= 1; ++rz) {
+            for (int ry = -1; ry <= 1; ++ry) {
+                for (int rx = -1; rx <= 1; ++rx) {
+                    const int code = leaf_code(lx + rx, ly + ry, lz + rz);
+                    codes[region_index(rx, ry, rz)] = code;
+                    leaf_neighbours[region_index(rx, ry, rz)] = code >= 0;
+                }
+            }
+        }
+
+        auto region_of = [](int b) { return b == 0 ? -1 : (b == BLOCK_DIM - 1 ? 1 : 0); };
+        for (int bz = 0; bz < BLOCK_DIM; ++bz) {
+            const int rz = region_of(bz);
+            const int z = lz * LEAF_DIM - 1 + bz;
+            for (int by = 0; by < BLOCK_DIM; ++by) {
+                const int ry = region_of(by);
+                const int y = ly * LEAF_DIM - 1 + by;
+                for (int bx = 0; bx < BLOCK_DIM; ++bx) {
+                    const int rx = region_of(bx);
+                    const int x = lx * LEAF_DIM - 1 + bx;
+                    const int code = codes[region_index(rx, ry, rz)];
+                    block[(bz * BLOCK_DIM + by) * BLOCK_DIM + bx] =
+                        code < 0 ? tile_value(code) : m_leaves[code].values[leaf_offset(x, y, z)];
+                }
+            }
+        }
+    }
+
+    // Polygonize the cells owned by a leaf: cells whose origin lies in the leaf, plus halo cells
+    // whose origin lies in a neighbouring tile. A halo cell touching several leaves is owned by the
+    // first of them in (z, y, x) order so each cell is polygonized exactly once.
+    int SparseScalarField3D::extract_leaf(float isolevel, int lx, int ly, int lz, std::vector<MCTriangle>& triangles) const {
+        float block[BLOCK_DIM * BLOCK_DIM * BLOCK_DIM];
+        bool leaf_neighbours[27];
+        gather_block(lx, ly, lz, block, leaf_neighbours);
+
+        const auto [min_it, max_it] = std::minmax_element(std::begin(block), std::end(block));
+        if (ScalarField3D::classify_vertex(*max_it, isolevel) == alice2::VertexClass::NEGATIVE ||
+            ScalarField3D::classify_vertex(*min_it, isolevel) != alice2::VertexClass::NEGATIVE) {
+            return 0;
+        }
+
+        const int ox = lx * LEAF_DIM;
+        const int oy = ly * LEAF_DIM;
+        const int oz = lz * LEAF_DIM;
+        auto region_range = [](int c, int o, int& first, int& last) {
+            first = c < o ? -1 : 0;
+            last = c == o + LEAF_DIM - 1 ? 1 : 0;
+        };
+
+        int active_cells = 0;
+        for (int k = std::max(0, oz - 1); k < std::min(m_res_z - 1, oz + LEAF_DIM); ++k) {
+            for (int j = std::max(0, oy - 1); j < std::min(m_res_y - 1, oy + LEAF_DIM); ++j) {
+                for (int i = std::max(0, ox - 1); i < std::min(m_res_x - 1, ox + LEAF_DIM); ++i) {
+                    int fx, tx, fy, ty, fz, tz;
+                    region_range(i, ox, fx, tx);
+                    region_range(j, oy, fy, ty);
+                    region_range(k, oz, fz, tz);
+
+                    if (fx < 0 || fy < 0 || fz < 0) {
+                        // Origin lies in a neighbour: skip if that neighbour is a leaf or precedes us
+                        bool owned = true;
+                        for (int rz = fz; rz <= tz && owned; ++rz) {
+                            for (int ry = fy; ry <= ty && owned; ++ry) {
+                                for (int rx = fx; rx <= tx && owned; ++rx) {
+                                    const bool precedes = rz < 0 || (rz == 0 && (ry < 0 || (ry == 0 && rx < 0)));
+                                    if (precedes && leaf_neighbours[region_index(rx, ry, rz)]) {
+                                        owned = false;
+                                    }
+                                }
+                            }
+                        }
+                        if (!owned) continue;
+                    }
+
+                    GridCell cell;
+                    static const int corner_offsets[8][3] = {
+                        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+                        {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+                    };
+                    for (int c = 0; c < 8; ++c) {
+                        const int x = i + corner_offsets[c][0];
+                        const int y = j + corner_offsets[c][1];
+                        const int z = k + corner_offsets[c][2];
+                        cell.vertices[c] = grid_point(x, y, z);
+                        cell.values[c] = block[((z - oz + 1) * BLOCK_DIM + (y - oy + 1)) * BLOCK_DIM + (x - ox + 1)];
+                        cell.classes[c] = ScalarField3D::classify_vertex(cell.values[c], isolevel);
+                    }
+
+                    if (ScalarField3D::polygonize_cell(cell, isolevel, triangles) > 0) {
+                        active_cells++;
+                    }
+                }
+            }
+        }
+        return active_cells;
+    }
+
+    // Extract triangles from the active leaves only. Leaves are visited in (z, y, x) order and
+    // split into contiguous chunks that are polygonized in parallel and concatenated in order.
+    std::vector<MCTriangle> SparseScalarField3D::extract_triangles(float isolevel) const {
+        std::vector<MCTriangle> triangles;
+        if (m_res_x < 2 || m_res_y < 2 || m_res_z < 2) {
+            return triangles;
+        }
+
+        struct LeafCoord {
+            int lx, ly, lz;
+        };
+        std::vector<LeafCoord> active;
+        active.reserve(m_leaves.size());
+        for (const auto& entry : m_root) {
+            if (entry.second < 0) continue;
+            const int nx = static_cast<int>(entry.first & 0x1FFFFF);
+            const int ny = static_cast<int>((entry.first >> 21) & 0x1FFFFF);
+            const int nz = static_cast<int>(entry.first >> 42);
+            const InternalNode& node = m_nodes[entry.second];
+            for (int slot = 0; slot < NODE_SIZE; ++slot) {
+                if (node.children[slot] < 0) continue;
+                active.push_back({nx * NODE_DIM + (slot & (NODE_DIM - 1)),
+                                  ny * NODE_DIM + ((slot >> NODE_LOG2) & (NODE_DIM - 1)),
+                                  nz * NODE_DIM + (slot >> (2 * NODE_LOG2))});
+            }
+        }
+        std::sort(active.begin(), active.end(), [](const LeafCoord& a, const LeafCoord& b) {
+            if (a.lz != b.lz) return a.lz < b.lz;
+            if (a.ly != b.ly) return a.ly < b.ly;
+            return a.lx < b.lx;
+        });
+
+        const int leaf_total = static_cast<int>(active.size());
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        const int chunk_count = std::max(1, std::min(leaf_total, num_threads == 1 ? 1 : num_threads * 16));
+        const int chunk_size = (leaf_total + chunk_count - 1) / chunk_count;
+
+        std::vector<std::vector<MCTriangle>> chunk_triangles(chunk_count);
+        parallel_for(chunk_count, num_threads, [&](int chunk) {
+            const int end = std::min(leaf_total, (chunk + 1) * chunk_size);
+            for (int l = chunk * chunk_size; l < end; ++l) {
+                extract_leaf(isolevel, active[l].lx, active[l].ly, active[l].lz, chunk_triangles[chunk]);
+            }
+        });
+
+        size_t total = 0;
+        for (const auto& chunk : chunk_triangles) {
+            total += chunk.size();
+        }
+        triangles.reserve(total);
+        for (const auto& chunk : chunk_triangles) {
+            triangles.insert(triangles.end(), chunk.begin(), chunk.end());
+        }
+
+        return triangles;
+    }
+
+    // Generate mesh data from the sparse field
+    std::shared_ptr<MeshData> SparseScalarField3D::generate_mesh(float isolevel) const {
+        auto meshData = std::make_shared<MeshData>();
+        std::vector<MCTriangle> triangles = extract_triangles(isolevel);
+
+        meshData->vertices.reserve(triangles.size() * 3);
+        meshData->faces.reserve(triangles.size());
+        for (const auto& triangle : triangles) {
+            int baseIndex = static_cast<int>(meshData->vertices.size());
+
+            for (int i = 0; i < 3; ++i) {
+                MeshVertex vertex;
+                vertex.position = triangle.vertices[i];
+                vertex.normal = triangle.normal;
+                vertex.color = Color(0.8f, 0.8f, 0.9f);
+                meshData->vertices.push_back(vertex);
+            }
+
+            MeshFace face;
+            face.vertices = {baseIndex, baseIndex + 1, baseIndex + 2};
+            face.normal = triangle.normal;
+            face.color = Color(0.8f, 0.8f, 0.9f);
+            meshData->faces.push_back(face);
+        }
+
+        meshData->triangulationDirty = true;
+        return meshData;
+    }
+
+} // namespace alice2
@@ -0,0 +1,163 @@
+#pragma once
+
+#ifndef ALICE2_SPARSE_SCALAR_FIELD_3D_H
+#define ALICE2_SPARSE_SCALAR_FIELD_3D_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "ScalarField3D.h"
+
+namespace alice2 {
+
+    class SdfExpression;
+
+    /**
+     * Narrow-band 3D scalar field with sparse storage.
+     * Values are only stored in 8^3 leaves that lie within band_width of the isosurface; the rest
+     * of the grid is represented by constant tiles (+band_width outside, -band_width inside).
+     * Leaves are organised in two levels: a root hash of internal nodes, each holding 16^3 child
+     * slots (128^3 grid points), and each slot referring to a leaf or a tile.
+     * The public API mirrors ScalarField3D; isolevels must lie strictly inside the band.
+     */
+    class SparseScalarField3D {
+    public:
+        static constexpr int LEAF_LOG2 = 3;
+        static constexpr int LEAF_DIM = 1 << LEAF_LOG2;                     // 8 points per leaf edge
+        static constexpr int LEAF_SIZE = LEAF_DIM * LEAF_DIM * LEAF_DIM;
+        static constexpr int NODE_LOG2 = 4;
+        static constexpr int NODE_DIM = 1 << NODE_LOG2;                     // 16 leaves per node edge
+        static constexpr int NODE_SIZE = NODE_DIM * NODE_DIM * NODE_DIM;
+
+        // Child / root codes for constant tiles
+        static constexpr int TILE_OUTSIDE = -1;
+        static constexpr int TILE_INSIDE = -2;
+
+    private:
+        struct Leaf {
+            float values[LEAF_SIZE];
+        };
+
+        struct InternalNode {
+            int children[NODE_SIZE];    // leaf index or tile code
+        };
+
+        // Grid properties
+        Vec3 m_min_bounds;
+        Vec3 m_max_bounds;
+        int m_res_x;
+        int m_res_y;
+        int m_res_z;
+        Vec3 m_grid_step;
+        float m_band_width;
+
+        // Sparse storage
+        std::unordered_map<uint64_t, int> m_root;   // internal node index or tile code; absent = outside
+        std::vector<InternalNode> m_nodes;
+        std::vector<Leaf> m_leaves;
+
+        // Extraction options
+        MCExtractSettings m_extract_settings;
+
+        // Helper methods
+        static inline uint64_t node_key(int nx, int ny, int nz) {
+            return (static_cast<uint64_t>(nz) << 42) | (static_cast<uint64_t>(ny) << 21) | static_cast<uint64_t>(nx);
+        }
+
+        static inline int child_slot(int lx, int ly, int lz) {
+            return ((lz & (NODE_DIM - 1)) * NODE_DIM + (ly & (NODE_DIM - 1))) * NODE_DIM + (lx & (NODE_DIM - 1));
+        }
+
+        static inline int leaf_offset(int x, int y, int z) {
+            return ((z & (LEAF_DIM - 1)) * LEAF_DIM + (y & (LEAF_DIM - 1))) * LEAF_DIM + (x & (LEAF_DIM - 1));
+        }
+
+        inline float tile_value(int code) const {
+            return code == TILE_INSIDE ? -m_band_width : m_band_width;
+        }
+
+        inline int tile_code(float value) const {
+            return value < 0.0f ? TILE_INSIDE : TILE_OUTSIDE;
+        }
+
+        inline Vec3 grid_point(int x, int y, int z) const {
+            return Vec3(m_min_bounds.x + x * m_grid_step.x,
+                        m_min_bounds.y + y * m_grid_step.y,
+                        m_min_bounds.z + z * m_grid_step.z);
+        }
+
+        inline bool is_valid_coords(int x, int y, int z) const {
+            return x >= 0 && x < m_res_x && y >= 0 && y < m_res_y && z >= 0 && z < m_res_z;
+        }
+
+        inline int leaf_count(int resolution) const { return (resolution + LEAF_DIM - 1) / LEAF_DIM; }
+        inline int node_count(int resolution) const { return (leaf_count(resolution) + NODE_DIM - 1) / NODE_DIM; }
+
+        // Code stored for leaf (lx, ly, lz): leaf index >= 0 or a tile code
+        int leaf_code(int lx, int ly, int lz) const;
+        int* leaf_code_slot(int lx, int ly, int lz);
+        Vec3 clamp_to_bounds(const Vec3& p) const;
+
+        template <typename CombineFn>
+        void combine(const SparseScalarField3D& other, CombineFn&& fn);
+        bool collapse_leaf(const Leaf& leaf, int& code) const;
+        void gather_block(int lx, int ly, int lz, float* block, bool* leaf_neighbours) const;
+        int extract_leaf(float isolevel, int lx, int ly, int lz, std::vector<MCTriangle>& triangles) const;
+
+    public:
+        // band_width <= 0 selects three cells of the coarsest axis spacing
+        SparseScalarField3D(const Vec3& min_bb = Vec3(-50, -50, -50),
+                            const Vec3& max_bb = Vec3(50, 50, 50),
+                            int res_x = 50,
+                            int res_y = 50,
+                            int res_z = 50,
+                            float band_width = 0.0f);
+
+        ~SparseScalarField3D() = default;
+        SparseScalarField3D(const SparseScalarField3D& other) = default;
+        SparseScalarField3D& operator=(const SparseScalarField3D& other) = default;
+        SparseScalarField3D(SparseScalarField3D&& other) noexcept = default;
+        SparseScalarField3D& operator=(SparseScalarField3D&& other) noexcept = default;
+
+        // Getter/Setter methods
+        std::tuple<int, int, int> get_resolution() const { return {m_res_x, m_res_y, m_res_z}; }
+        std::pair<Vec3, Vec3> get_bounds() const { return {m_min_bounds, m_max_bounds}; }
+        float get_band_width() const { return m_band_width; }
+        float get_value(int x, int y, int z) const;
+        void set_value(int x, int y, int z, float value);
+        int get_leaf_count() const { return static_cast<int>(m_leaves.size()); }
+        size_t get_memory_usage() const;
+
+        Vec3 cell_position(int x, int y, int z) const;
+        float sample_trilinear(const Vec3& p) const;
+        Vec3 gradient_at(const Vec3& p) const;
+        Vec3 gradient_normalized(const Vec3& p) const;
+        Vec3 get_cell_size() const;
+        float value_at(const Vec3& p) const;
+        bool contains_point(const Vec3& p) const;
+
+        // Field generation methods
+        void clear_field();
+        void apply_sdf(const SdfExpression& expression);
+        void apply_scalar_sphere(const Vec3& center, float radius);
+        void apply_scalar_box(const Vec3& center, const Vec3& half_size);
+        void apply_scalar_torus(const Vec3& center, float major_radius, float minor_radius);
+        void apply_scalar_plane(const Vec3& point, const Vec3& normal);
+
+        // Boolean operations (fields must share bounds and resolution)
+        void boolean_union(const SparseScalarField3D& other);
+        void boolean_intersect(const SparseScalarField3D& other);
+        void boolean_subtract(const SparseScalarField3D& other);
+        void boolean_smin(const SparseScalarField3D& other, float smoothing = 1.0f);
+
+        // Marching cubes mesh generation over the active leaves
+        std::shared_ptr<MeshData> generate_mesh(float isolevel = 0.0f) const;
+        std::vector<MCTriangle> extract_triangles(float isolevel = 0.0f) const;
+        void set_extract_settings(const MCExtractSettings& settings) { m_extract_settings = settings; }
+        const MCExtractSettings& get_extract_settings() const { return m_extract_settings; }
+    };
+
+} // namespace alice2
+
+#endif // ALICE2_SPARSE_SCALAR_FIELD_3D_H
@@ -0,0 +1,389 @@
+#include "TiledScalarField3D.h"
+#include "SdfExpression.h"
+#include "../objects/MeshObject.h"
+#include "../utils/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace alice2 {
+
+    namespace {
+        constexpr int BLOCK_DIM = TiledScalarField3D::TILE_DIM + 1;     // tile plus the far face shared with its neighbours
+    }
+
+    // Constructor
+    TiledScalarField3D::TiledScalarField3D(const std::string& path, const Vec3& min_bb, const Vec3& max_bb,
+                                           int res_x, int res_y, int res_z, int resident_tiles)
+        : m_min_bounds(min_bb), m_max_bounds(max_bb), m_res_x(res_x), m_res_y(res_y), m_res_z(res_z),
+          m_path(path), m_resident_budget(std::max(1, resident_tiles)) {
+        if (res_x <= 0 || res_y <= 0 || res_z <= 0) {
+            throw std::invalid_argument("Resolution must be positive");
+        }
+
+        m_grid_step = get_cell_size();
+        m_tiles_x = (res_x + TILE_DIM - 1) / TILE_DIM;
+        m_tiles_y = (res_y + TILE_DIM - 1) / TILE_DIM;
+        m_tiles_z = (res_z + TILE_DIM - 1) / TILE_DIM;
+        const size_t tile_count = static_cast<size_t>(m_tiles_x) * m_tiles_y * m_tiles_z;
+        m_tiles.resize(tile_count);
+
+        if (!m_file.open(path, MappedFile::Mode::ReadWrite, tile_count * TILE_BYTES)) {
+            throw std::runtime_error("Failed to open tile file " + path);
+        }
+    }
+
+    TiledScalarField3D::~TiledScalarField3D() {
+        unmap_all();
+    }
+
+    Vec3 TiledScalarField3D::get_cell_size() const {
+        return Vec3(
+            (m_max_bounds.x - m_min_bounds.x) / std::max(1, m_res_x - 1),
+            (m_max_bounds.y - m_min_bounds.y) / std::max(1, m_res_y - 1),
+            (m_max_bounds.z - m_min_bounds.z) / std::max(1, m_res_z - 1)
+        );
+    }
+
+    Vec3 TiledScalarField3D::cell_position(int x, int y, int z) const {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        return grid_point(x, y, z);
+    }
+
+    bool TiledScalarField3D::contains_point(const Vec3& p) const {
+        return p.x >= m_min_bounds.x && p.x <= m_max_bounds.x &&
+               p.y >= m_min_bounds.y && p.y <= m_max_bounds.y &&
+               p.z >= m_min_bounds.z && p.z <= m_max_bounds.z;
+    }
+
+    // Tile cache. A pinned tile stays mapped; unpinned resident tiles wait in the LRU list and
+    // are unmapped from its front whenever more than the budget are mapped.
+    float* TiledScalarField3D::pin_tile(int tile) const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        TileSlot& slot = m_tiles[tile];
+        if (slot.view) {
+            if (slot.pins == 0) {
+                m_lru.erase(slot.lru);
+            }
+        } else {
+            slot.view = static_cast<float*>(m_file.map(static_cast<uint64_t>(tile) * TILE_BYTES, TILE_BYTES));
+            if (!slot.view) {
+                throw std::runtime_error("Failed to map tile of " + m_path);
+            }
+            ++m_resident_count;
+        }
+        ++slot.pins;
+        evict_over_budget();
+        return slot.view;
+    }
+
+    void TiledScalarField3D::unpin_tile(int tile) const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        TileSlot& slot = m_tiles[tile];
+        if (--slot.pins == 0) {
+            slot.lru = m_lru.insert(m_lru.end(), tile);
+            evict_over_budget();
+        }
+    }
+
+    // Caller holds m_cache_mutex
+    void TiledScalarField3D::evict_over_budget() const {
+        while (m_resident_count > m_resident_budget && !m_lru.empty()) {
+            TileSlot& slot = m_tiles[m_lru.front()];
+            m_lru.pop_front();
+            MappedFile::unmap(slot.view, TILE_BYTES);
+            slot.view = nullptr;
+            --m_resident_count;
+        }
+    }
+
+    void TiledScalarField3D::unmap_all() const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        for (TileSlot& slot : m_tiles) {
+            MappedFile::unmap(slot.view, TILE_BYTES);
+            slot.view = nullptr;
+            slot.pins = 0;
+        }
+        m_lru.clear();
+        m_resident_count = 0;
+    }
+
+    void TiledScalarField3D::set_resident_budget(int tiles) {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        m_resident_budget = std::max(1, tiles);
+        evict_over_budget();
+    }
+
+    int TiledScalarField3D::get_resident_count() const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        return m_resident_count;
+    }
+
+    void TiledScalarField3D::flush() const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        for (const TileSlot& slot : m_tiles) {
+            MappedFile::flush(slot.view, TILE_BYTES);
+        }
+    }
+
+    float TiledScalarField3D::get_value(int x, int y, int z) const {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        TileRef tile(*this, tile_index(x >> TILE_LOG2, y >> TILE_LOG2, z >> TILE_LOG2));
+        return tile.data()[tile_offset(x, y, z)];
+    }
+
+    void TiledScalarField3D::set_value(int x, int y, int z, float value) {
+        if (!is_valid_coords(x, y, z)) {
+            throw std::out_of_range("Invalid grid coordinates");
+        }
+        TileRef tile(*this, tile_index(x >> TILE_LOG2, y >> TILE_LOG2, z >> TILE_LOG2));
+        tile.data()[tile_offset(x, y, z)] = value;
+    }
+
+    // Field generation: tiles are independent, so each worker maps, fills and releases one tile
+    // at a time and the working set stays at the budget plus one tile per worker
+    void TiledScalarField3D::clear_field(float value) {
+        parallel_for(get_tile_count(), m_extract_settings.num_threads, [&](int t) {
+            TileRef tile(*this, t);
+            std::fill(tile.data(), tile.data() + TILE_SIZE, value);
+        });
+    }
+
+    void TiledScalarField3D::apply_sdf(const SdfExpression& expression) {
+        parallel_for(get_tile_count(), m_extract_settings.num_threads, [&](int t) {
+            const int ox = (t % m_tiles_x) * TILE_DIM;
+            const int oy = ((t / m_tiles_x) % m_tiles_y) * TILE_DIM;
+            const int oz = (t / (m_tiles_x * m_tiles_y)) * TILE_DIM;
+            const int count = std::min(TILE_DIM, m_res_x - ox);
+            float xs[TILE_DIM], ys[TILE_DIM], zs[TILE_DIM];
+            std::vector<float> scratch;
+
+            TileRef tile(*this, t);
+            for (int z = oz; z < std::min(m_res_z, oz + TILE_DIM); ++z) {
+                for (int y = oy; y < std::min(m_res_y, oy + TILE_DIM); ++y) {
+                    for (int n = 0; n < count; ++n) {
+                        const Vec3 pt = grid_point(ox + n, y, z);
+                        xs[n] = pt.x;
+                        ys[n] = pt.y;
+                        zs[n] = pt.z;
+                    }
+                    expression.evaluate(xs, ys, zs, count, tile.data() + tile_offset(ox, y, z), scratch);
+                }
+            }
+        });
+    }
+
+    void TiledScalarField3D::apply_scalar_sphere(const Vec3& center, float radius) {
+        apply_sdf(SdfExpression::sphere(center, radius));
+    }
+
+    void TiledScalarField3D::apply_scalar_box(const Vec3& center, const Vec3& half_size) {
+        apply_sdf(SdfExpression::box(center, half_size));
+    }
+
+    void TiledScalarField3D::apply_scalar_torus(const Vec3& center, float major_radius, float minor_radius) {
+        apply_sdf(SdfExpression::torus(center, major_radius, minor_radius));
+    }
+
+    void TiledScalarField3D::apply_scalar_plane(const Vec3& point, const Vec3& normal) {
+        apply_sdf(SdfExpression::plane(point, normal));
+    }
+
+    // Combine with another field of the same layout, tile by tile. Padding beyond the grid edge
+    // is combined too; it is never read back.
+    template <typename CombineFn>
+    void TiledScalarField3D::combine(const TiledScalarField3D& other, CombineFn&& fn) {
+        if (m_res_x != other.m_res_x || m_res_y != other.m_res_y || m_res_z != other.m_res_z) {
+            return; // Skip if sizes don't match
+        }
+
+        parallel_for(get_tile_count(), m_extract_settings.num_threads, [&](int t) {
+            TileRef tile(*this, t);
+            TileRef other_tile(other, t);
+            float* values = tile.data();
+            const float* other_values = other_tile.data();
+            for (int n = 0; n < TILE_SIZE; ++n) {
+                values[n] = fn(values[n], other_values[n]);
+            }
+        });
+    }
+
+    void TiledScalarField3D::boolean_union(const TiledScalarField3D& other) {
+        combine(other, [](float a, float b) { return std::min(a, b); });
+    }
+
+    void TiledScalarField3D::boolean_intersect(const TiledScalarField3D& other) {
+        combine(other, [](float a, float b) { return std::max(a, b); });
+    }
+
+    void TiledScalarField3D::boolean_subtract(const TiledScalarField3D& other) {
+        combine(other, [](float a, float b) { return std::max(a, -b); });
+    }
+
+    void TiledScalarField3D::boolean_smin(const TiledScalarField3D& other, float smoothing) {
+        combine(other, [smoothing](float a, float b) {
+            float r = std::exp2(-a / smoothing) + std::exp2(-b / smoothing);
+            return -smoothing * std::log2(r);
+        });
+    }
+
+    // Values of grid points [o, o + TILE_DIM] around tile (tx, ty, tz), where o is the tile origin.
+    // The far faces come from up to seven neighbouring tiles, each mapped only while it is copied.
+    // Points beyond the grid edge are left untouched.
+    void TiledScalarField3D::gather_block(int tx, int ty, int tz, float* block) const {
+        const int ox = tx * TILE_DIM;
+        const int oy = ty * TILE_DIM;
+        const int oz = tz * TILE_DIM;
+        const int ex = std::min(m_res_x - 1, ox + TILE_DIM);
+        const int ey = std::min(m_res_y - 1, oy + TILE_DIM);
+        const int ez = std::min(m_res_z - 1, oz + TILE_DIM);
+
+        for (int dz = 0; dz <= 1; ++dz) {
+            for (int dy = 0; dy <= 1; ++dy) {
+                for (int dx = 0; dx <= 1; ++dx) {
+                    if (tx + dx >= m_tiles_x || ty + dy >= m_tiles_y || tz + dz >= m_tiles_z) continue;
+                    // Neighbour tiles contribute only their first layer of points
+                    const int x0 = ox + dx * TILE_DIM, x1 = dx ? std::min(ex, x0) : std::min(ex, ox + TILE_DIM - 1);
+                    const int y0 = oy + dy * TILE_DIM, y1 = dy ? std::min(ey, y0) : std::min(ey, oy + TILE_DIM - 1);
+                    const int z0 = oz + dz * TILE_DIM, z1 = dz ? std::min(ez, z0) : std::min(ez, oz + TILE_DIM - 1);
+                    if (x0 > x1 || y0 > y1 || z0 > z1) continue;
+
+                    TileRef tile(*this, tile_index(tx + dx, ty + dy, tz + dz));
+                    const float* values = tile.data();
+                    for (int z = z0; z <= z1; ++z) {
+                        for (int y = y0; y <= y1; ++y) {
+                            std::copy(values + tile_offset(x0, y, z), values + tile_offset(x0, y, z) + (x1 - x0 + 1),
+                                      block + ((z - oz) * BLOCK_DIM + (y - oy)) * BLOCK_DIM + (x0 - ox));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Polygonize the cells whose origin lies in the tile
+    int TiledScalarField3D::extract_tile(float isolevel, int tx, int ty, int tz, std::vector<MCTriangle>& triangles) const {
+        std::vector<float> block(static_cast<size_t>(BLOCK_DIM) * BLOCK_DIM * BLOCK_DIM);
+        gather_block(tx, ty, tz, block.data());
+
+        const int ox = tx * TILE_DIM;
+        const int oy = ty * TILE_DIM;
+        const int oz = tz * TILE_DIM;
+        const int ex = std::min(m_res_x - 1, ox + TILE_DIM);
+        const int ey = std::min(m_res_y - 1, oy + TILE_DIM);
+        const int ez = std::min(m_res_z - 1, oz + TILE_DIM);
+        auto block_value = [&](int x, int y, int z) {
+            return block[((z - oz) * BLOCK_DIM + (y - oy)) * BLOCK_DIM + (x - ox)];
+        };
+
+        float min_value = block_value(ox, oy, oz);
+        float max_value = min_value;
+        for (int z = oz; z <= ez; ++z) {
+            for (int y = oy; y <= ey; ++y) {
+                for (int x = ox; x <= ex; ++x) {
+                    min_value = std::min(min_value, block_value(x, y, z));
+                    max_value = std::max(max_value, block_value(x, y, z));
+                }
+            }
+        }
+        if (ScalarField3D::classify_vertex(max_value, isolevel) == alice2::VertexClass::NEGATIVE ||
+            ScalarField3D::classify_vertex(min_value, isolevel) != alice2::VertexClass::NEGATIVE) {
+            return 0;
+        }
+
+        static const int corner_offsets[8][3] = {
+            {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+            {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+        };
+
+        int active_cells = 0;
+        for (int k = oz; k < ez; ++k) {
+            for (int j = oy; j < ey; ++j) {
+                for (int i = ox; i < ex; ++i) {
+                    GridCell cell;
+                    for (int c = 0; c < 8; ++c) {
+                        const int x = i + corner_offsets[c][0];
+                        const int y = j + corner_offsets[c][1];
+                        const int z = k + corner_offsets[c][2];
+                        cell.vertices[c] = grid_point(x, y, z);
+                        cell.values[c] = block_value(x, y, z);
+                        cell.classes[c] = ScalarField3D::classify_vertex(cell.values[c], isolevel);
+                    }
+
+                    if (ScalarField3D::polygonize_cell(cell, isolevel, triangles) > 0) {
+                        active_cells++;
+                    }
+                }
+            }
+        }
+        return active_cells;
+    }
+
+    // Extract triangles tile by tile. Tiles are visited in file order and split into contiguous
+    // chunks that are polygonized in parallel and concatenated in order.
+    std::vector<MCTriangle> TiledScalarField3D::extract_triangles(float isolevel) const {
+        std::vector<MCTriangle> triangles;
+        if (m_res_x < 2 || m_res_y < 2 || m_res_z < 2) {
+            return triangles;
+        }
+
+        const int tile_total = get_tile_count();
+        const int num_threads = resolve_thread_count(m_extract_settings.num_threads);
+        const int chunk_count = std::max(1, std::min(tile_total, num_threads == 1 ? 1 : num_threads * 16));
+        const int chunk_size = (tile_total + chunk_count - 1) / chunk_count;
+
+        std::vector<std::vector<MCTriangle>> chunk_triangles(chunk_count);
+        parallel_for(chunk_count, num_threads, [&](int chunk) {
+            const int end = std::min(tile_total, (chunk + 1) * chunk_size);
+            for (int t = chunk * chunk_size; t < end; ++t) {
+                extract_tile(isolevel, t % m_tiles_x, (t / m_tiles_x) % m_tiles_y,
+                             t / (m_tiles_x * m_tiles_y), chunk_triangles[chunk]);
+            }
+        });
+
+        size_t total = 0;
+        for (const auto& chunk : chunk_triangles) {
+            total += chunk.size();
+        }
+        triangles.reserve(total);
+        for (const auto& chunk : chunk_triangles) {
+            triangles.insert(triangles.end(), chunk.begin(), chunk.end());
+        }
+
+        return triangles;
+    }
+
+    // Generate mesh data from the tiled field
+    std::shared_ptr<MeshData> TiledScalarField3D::generate_mesh(float isolevel) const {
+        auto meshData = std::make_shared<MeshData>();
+        std::vector<MCTriangle> triangles = extract_triangles(isolevel);
+
+        meshData->vertices.reserve(triangles.size() * 3);
+        meshData->faces.reserve(triangles.size());
+        for (const auto& triangle : triangles) {
+            int baseIndex = static_cast<int>(meshData->vertices.size());
+
+            for (int i = 0; i < 3; ++i) {
+                MeshVertex vertex;
+                vertex.position = triangle.vertices[i];
+                vertex.normal = triangle.normal;
+                vertex.color = Color(0.8f, 0.8f, 0.9f);
+                meshData->vertices.push_back(vertex);
+            }
+
+            MeshFace face;
+            face.vertices = {baseIndex, baseIndex + 1, baseIndex + 2};
+            face.normal = triangle.normal;
+            face.color = Color(0.8f, 0.8f, 0.9f);
+            meshData->faces.push_back(face);
+        }
+
+        meshData->triangulationDirty = true;
+        return meshData;
+    }
+
+} // namespace alice2
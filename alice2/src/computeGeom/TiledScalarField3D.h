@@ -0,0 +1,169 @@
+#pragma once
+
+#ifndef ALICE2_TILED_SCALAR_FIELD_3D_H
+#define ALICE2_TILED_SCALAR_FIELD_3D_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include "ScalarField3D.h"
+#include "../utils/MappedFile.h"
+
+namespace alice2 {
+
+    class SdfExpression;
+
+    /**
+     * Out-of-core dense 3D scalar field.
+     * Values live in a backing file as 32^3 tiles (128 KB each, x fastest inside a tile, tiles in
+     * (z, y, x) order). Tiles are memory-mapped on first touch and unmapped least recently used
+     * first once more than the resident budget are mapped, so generators, boolean ops and marching
+     * cubes stream over volumes larger than RAM with a bounded working set.
+     * An existing backing file of the right size is reused as is, so a volume can be reopened
+     * with the same bounds and resolution.
+     */
+    class TiledScalarField3D {
+    public:
+        static constexpr int TILE_LOG2 = 5;
+        static constexpr int TILE_DIM = 1 << TILE_LOG2;                     // 32 points per tile edge
+        static constexpr int TILE_SIZE = TILE_DIM * TILE_DIM * TILE_DIM;
+        static constexpr size_t TILE_BYTES = TILE_SIZE * sizeof(float);     // multiple of the 64 KB Windows granularity
+
+    private:
+        struct TileSlot {
+            float* view = nullptr;          // mapped values, nullptr while not resident
+            int pins = 0;                   // users currently reading or writing the view
+            std::list<int>::iterator lru;   // position in m_lru while resident and unpinned
+        };
+
+        // Keeps a tile mapped for the lifetime of the handle
+        class TileRef {
+        public:
+            TileRef(const TiledScalarField3D& field, int tile) : m_field(field), m_tile(tile), m_data(field.pin_tile(tile)) {}
+            ~TileRef() { m_field.unpin_tile(m_tile); }
+            TileRef(const TileRef&) = delete;
+            TileRef& operator=(const TileRef&) = delete;
+            float* data() const { return m_data; }
+
+        private:
+            const TiledScalarField3D& m_field;
+            int m_tile;
+            float* m_data;
+        };
+
+        // Grid properties
+        Vec3 m_min_bounds;
+        Vec3 m_max_bounds;
+        int m_res_x;
+        int m_res_y;
+        int m_res_z;
+        Vec3 m_grid_step;
+        int m_tiles_x;
+        int m_tiles_y;
+        int m_tiles_z;
+
+        // Backing store and resident tile cache
+        std::string m_path;
+        MappedFile m_file;
+        int m_resident_budget;
+        mutable std::mutex m_cache_mutex;
+        mutable std::vector<TileSlot> m_tiles;
+        mutable std::list<int> m_lru;       // resident unpinned tiles, least recently used first
+        mutable int m_resident_count = 0;
+
+        // Extraction options
+        MCExtractSettings m_extract_settings;
+
+        // Helper methods
+        inline Vec3 grid_point(int x, int y, int z) const {
+            return Vec3(m_min_bounds.x + x * m_grid_step.x,
+                        m_min_bounds.y + y * m_grid_step.y,
+                        m_min_bounds.z + z * m_grid_step.z);
+        }
+
+        inline bool is_valid_coords(int x, int y, int z) const {
+            return x >= 0 && x < m_res_x && y >= 0 && y < m_res_y && z >= 0 && z < m_res_z;
+        }
+
+        inline int tile_index(int tx, int ty, int tz) const {
+            return (tz * m_tiles_y + ty) * m_tiles_x + tx;
+        }
+
+        static inline int tile_offset(int x, int y, int z) {
+            return ((z & (TILE_DIM - 1)) * TILE_DIM + (y & (TILE_DIM - 1))) * TILE_DIM + (x & (TILE_DIM - 1));
+        }
+
+        float* pin_tile(int tile) const;
+        void unpin_tile(int tile) const;
+        void evict_over_budget() const;
+        void unmap_all() const;
+
+        template <typename CombineFn>
+        void combine(const TiledScalarField3D& other, CombineFn&& fn);
+        void gather_block(int tx, int ty, int tz, float* block) const;
+        int extract_tile(float isolevel, int tx, int ty, int tz, std::vector<MCTriangle>& triangles) const;
+
+    public:
+        // Opens or creates the backing file; throws std::runtime_error if it cannot be mapped
+        TiledScalarField3D(const std::string& path,
+                           const Vec3& min_bb = Vec3(-50, -50, -50),
+                           const Vec3& max_bb = Vec3(50, 50, 50),
+                           int res_x = 50,
+                           int res_y = 50,
+                           int res_z = 50,
+                           int resident_tiles = 256);
+
+        ~TiledScalarField3D();
+
+        // The tile cache owns mapped views of a single file, so fields are neither copied nor moved
+        TiledScalarField3D(const TiledScalarField3D& other) = delete;
+        TiledScalarField3D& operator=(const TiledScalarField3D& other) = delete;
+
+        // Getter/Setter methods
+        std::tuple<int, int, int> get_resolution() const { return {m_res_x, m_res_y, m_res_z}; }
+        std::pair<Vec3, Vec3> get_bounds() const { return {m_min_bounds, m_max_bounds}; }
+        const std::string& get_path() const { return m_path; }
+        int get_tile_count() const { return static_cast<int>(m_tiles.size()); }
+        float get_value(int x, int y, int z) const;
+        void set_value(int x, int y, int z, float value);
+
+        // Resident tile budget (at least 1). Tiles in use by a running operation are never evicted,
+        // so up to one extra tile per worker thread may be mapped transiently.
+        void set_resident_budget(int tiles);
+        int get_resident_budget() const { return m_resident_budget; }
+        int get_resident_count() const;
+        size_t get_memory_usage() const { return static_cast<size_t>(get_resident_count()) * TILE_BYTES; }
+        // Write all resident tiles back to the file
+        void flush() const;
+
+        Vec3 cell_position(int x, int y, int z) const;
+        Vec3 get_cell_size() const;
+        bool contains_point(const Vec3& p) const;
+
+        // Field generation methods, streamed tile by tile
+        void clear_field(float value = 0.0f);
+        void apply_sdf(const SdfExpression& expression);
+        void apply_scalar_sphere(const Vec3& center, float radius);
+        void apply_scalar_box(const Vec3& center, const Vec3& half_size);
+        void apply_scalar_torus(const Vec3& center, float major_radius, float minor_radius);
+        void apply_scalar_plane(const Vec3& point, const Vec3& normal);
+
+        // Boolean operations (fields must share resolution)
+        void boolean_union(const TiledScalarField3D& other);
+        void boolean_intersect(const TiledScalarField3D& other);
+        void boolean_subtract(const TiledScalarField3D& other);
+        void boolean_smin(const TiledScalarField3D& other, float smoothing = 1.0f);
+
+        // Marching cubes mesh generation, one tile (plus its far faces) at a time
+        std::shared_ptr<MeshData> generate_mesh(float isolevel = 0.0f) const;
+        std::vector<MCTriangle> extract_triangles(float isolevel = 0.0f) const;
+        void set_extract_settings(const MCExtractSettings& settings) { m_extract_settings = settings; }
+        const MCExtractSettings& get_extract_settings() const { return m_extract_settings; }
+    };
+
+} // namespace alice2
+
+#endif // ALICE2_TILED_SCALAR_FIELD_3D_H
@@ -1,6 +1,9 @@
 #include <computeGeom/ScalarField.h>
 #include "../objects/GraphObject.h"
-#include <unordered_map>
+#include "SdfExpression.h"
+#include "../utils/Parallel.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
 
@@ -13,7 +16,6 @@ ScalarField2D::ScalarField2D(const Vec3& min_bb, const Vec3& max_bb, int res_x,
     }
 
     const int total_points = m_res_x * m_res_y;
-    m_grid_points.reserve(total_points);
     m_field_values.resize(total_points, 0.0f);
     m_normalized_values.resize(total_points, 0.0f);
     m_gradient_field.resize(total_points, Vec3(0, 0, 0));
@@ -25,9 +27,11 @@ ScalarField2D::ScalarField2D(const Vec3& min_bb, const Vec3& max_bb, int res_x,
 ScalarField2D::ScalarField2D(const ScalarField2D& other)
     : m_min_bounds(other.m_min_bounds), m_max_bounds(other.m_max_bounds)
     , m_res_x(other.m_res_x), m_res_y(other.m_res_y)
-    , m_grid_points(other.m_grid_points), m_field_values(other.m_field_values)
+    , m_grid_origin(other.m_grid_origin), m_grid_step(other.m_grid_step)
+    , m_point_transform(other.m_point_transform), m_has_transform(other.m_has_transform)
+    , m_field_values(other.m_field_values)
     , m_normalized_values(other.m_normalized_values), m_gradient_field(other.m_gradient_field)
-    , m_has_valid_sdf(other.m_has_valid_sdf) {
+    , m_has_valid_sdf(other.m_has_valid_sdf), m_version(other.m_version) {
 }
 
 ScalarField2D& ScalarField2D::operator=(const ScalarField2D& other) {
@@ -36,11 +40,18 @@ ScalarField2D& ScalarField2D::operator=(const ScalarField2D& other) {
         m_max_bounds = other.m_max_bounds;
         m_res_x = other.m_res_x;
         m_res_y = other.m_res_y;
-        m_grid_points = other.m_grid_points;
+        m_grid_origin = other.m_grid_origin;
+        m_grid_step = other.m_grid_step;
+        m_point_transform = other.m_point_transform;
+        m_has_transform = other.m_has_transform;
+        m_points_cache.clear();
         m_field_values = other.m_field_values;
         m_normalized_values = other.m_normalized_values;
         m_gradient_field = other.m_gradient_field;
         m_has_valid_sdf = other.m_has_valid_sdf;
+        // Past this object's own versions, so its cached contours can never match again
+        m_version = std::max(m_version, other.m_version) + 1;
+        m_contour_cache.clear();
     }
     return *this;
 }
@@ -48,9 +59,12 @@ ScalarField2D& ScalarField2D::operator=(const ScalarField2D& other) {
 ScalarField2D::ScalarField2D(ScalarField2D&& other) noexcept
     : m_min_bounds(std::move(other.m_min_bounds)), m_max_bounds(std::move(other.m_max_bounds))
     , m_res_x(other.m_res_x), m_res_y(other.m_res_y)
-    , m_grid_points(std::move(other.m_grid_points)), m_field_values(std::move(other.m_field_values))
+    , m_grid_origin(other.m_grid_origin), m_grid_step(other.m_grid_step)
+    , m_point_transform(other.m_point_transform), m_has_transform(other.m_has_transform)
+    , m_points_cache(std::move(other.m_points_cache)), m_field_values(std::move(other.m_field_values))
     , m_normalized_values(std::move(other.m_normalized_values)), m_gradient_field(std::move(other.m_gradient_field))
-    , m_has_valid_sdf(other.m_has_valid_sdf) {
+    , m_has_valid_sdf(other.m_has_valid_sdf), m_version(other.m_version)
+    , m_contour_cache(std::move(other.m_contour_cache)) {
     other.m_res_x = other.m_res_y = 0;
     other.m_has_valid_sdf = false;
 }
@@ -61,11 +75,17 @@ ScalarField2D& ScalarField2D::operator=(ScalarField2D&& other) noexcept {
         m_max_bounds = std::move(other.m_max_bounds);
         m_res_x = other.m_res_x;
         m_res_y = other.m_res_y;
-        m_grid_points = std::move(other.m_grid_points);
+        m_grid_origin = other.m_grid_origin;
+        m_grid_step = other.m_grid_step;
+        m_point_transform = other.m_point_transform;
+        m_has_transform = other.m_has_transform;
+        m_points_cache = std::move(other.m_points_cache);
         m_field_values = std::move(other.m_field_values);
         m_normalized_values = std::move(other.m_normalized_values);
         m_gradient_field = std::move(other.m_gradient_field);
         m_has_valid_sdf = other.m_has_valid_sdf;
+        m_version = std::max(m_version, other.m_version) + 1;
+        m_contour_cache.clear();
         other.m_res_x = other.m_res_y = 0;
         other.m_has_valid_sdf = false;
     }
@@ -74,20 +94,25 @@ ScalarField2D& ScalarField2D::operator=(ScalarField2D&& other) noexcept {
 
 // Helper method implementations
 void ScalarField2D::initialize_grid() {
-    m_grid_points.clear();
-    m_grid_points.reserve(m_res_x * m_res_y);
-
     const Vec3 span = m_max_bounds - m_min_bounds;
-    const float step_x = span.x / (m_res_x - 1);
-    const float step_y = span.y / (m_res_y - 1);
+    m_grid_origin = m_min_bounds;
+    m_grid_step = Vec3(span.x / std::max(1, m_res_x - 1), span.y / std::max(1, m_res_y - 1), 0.0f);
+    m_point_transform.identity();
+    m_has_transform = false;
+    m_points_cache.clear();
+}
 
-    for (int j = 0; j < m_res_y; ++j) {
-        for (int i = 0; i < m_res_x; ++i) {
-            const float x = m_min_bounds.x + i * step_x;
-            const float y = m_min_bounds.y + j * step_y;
-            m_grid_points.emplace_back(x, y, 0.0f);
+// Compatibility view of all grid point positions, built on first use
+const std::vector<Vec3>& ScalarField2D::get_points() const {
+    if (m_points_cache.empty()) {
+        m_points_cache.reserve(m_field_values.size());
+        for (int j = 0; j < m_res_y; ++j) {
+            for (int i = 0; i < m_res_x; ++i) {
+                m_points_cache.push_back(grid_point(i, j));
+            }
         }
     }
+    return m_points_cache;
 }
 
 void ScalarField2D::normalize_field() {
@@ -119,12 +144,12 @@ void ScalarField2D::clear_field() {
     std::fill(m_field_values.begin(), m_field_values.end(), 0.0f);
     std::fill(m_normalized_values.begin(), m_normalized_values.end(), 0.0f);
     m_has_valid_sdf = false;
+    on_values_changed();
 }
 
 Vec3 ScalarField2D::cellPosition(int x, int y) const
 {
-    int index = y * m_res_x + x;
-    return m_grid_points[index];
+    return grid_point(x, y);
 }
 
 Vec3 ScalarField2D::get_gradient_at(const Vec3 &p) const
@@ -172,13 +197,14 @@ void ScalarField2D::apply_scalar_circle(const Vec3& center, float radius) {
     for (int j = 0; j < m_res_y; ++j) {
         for (int i = 0; i < m_res_x; ++i) {
             const int idx = get_index(i, j);
-            const Vec3& pt = m_grid_points[idx];
+            const Vec3 pt = grid_point(i, j);
             const float d = ScalarFieldUtils::distance_to(pt, center);
             const float sdf = d - radius; // SDF: negative inside, positive outside
             m_field_values[idx] = sdf;
         }
     }
     m_has_valid_sdf = true;
+    on_values_changed();
 }
 
 void ScalarField2D::apply_scalar_rect(const Vec3& center, const Vec3& half_size, float angle_radians) {
@@ -188,7 +214,7 @@ void ScalarField2D::apply_scalar_rect(const Vec3& center, const Vec3& half_size,
     for (int j = 0; j < m_res_y; ++j) {
         for (int i = 0; i < m_res_x; ++i) {
             const int idx = get_index(i, j);
-            const Vec3 p = m_grid_points[idx] - center;
+            const Vec3 p = grid_point(i, j) - center;
 
             // Rotate point into box's local frame
             const Vec3 pr(
@@ -207,126 +233,397 @@ void ScalarField2D::apply_scalar_rect(const Vec3& center, const Vec3& half_size,
         }
     }
     m_has_valid_sdf = true;
+    on_values_changed();
 }
 
-void ScalarField2D::apply_scalar_voronoi(const std::vector<Vec3>& sites) {
-    for (int j = 0; j < m_res_y; ++j) {
-        for (int i = 0; i < m_res_x; ++i) {
-            const int idx = get_index(i, j);
-            const Vec3& pt = m_grid_points[idx];
-
-            float min_dist = std::numeric_limits<float>::max();
-            float second_min_dist = std::numeric_limits<float>::max();
-
-            for (const auto& site : sites) {
-                const float d = ScalarFieldUtils::distance_to(pt, site);
-                if (d < min_dist) {
-                    second_min_dist = min_dist;
-                    min_dist = d;
-                } else if (d < second_min_dist) {
-                    second_min_dist = d;
+namespace {
+
+// Uniform grid over the sites' xy extent, sized for about one site per bin. Nearest-site queries
+// search rings of bins outwards and stop once the distance to the unsearched bins exceeds the
+// second-best distance, so results are exact (ties go to the lower site index, as a linear scan).
+struct SiteGrid {
+    float origin_x = 0.0f, origin_y = 0.0f;
+    float bin_size = 1.0f;
+    int bins_x = 1, bins_y = 1;
+    std::vector<int> bin_start;     // sites of bin b are bin_sites[bin_start[b] .. bin_start[b + 1])
+    std::vector<int> bin_sites;
+
+    explicit SiteGrid(const std::vector<Vec3>& sites) {
+        if (sites.empty()) {
+            bin_start.assign(2, 0);
+            return;
+        }
+        float min_x = sites[0].x, max_x = sites[0].x, min_y = sites[0].y, max_y = sites[0].y;
+        for (const Vec3& site : sites) {
+            min_x = std::min(min_x, site.x);
+            max_x = std::max(max_x, site.x);
+            min_y = std::min(min_y, site.y);
+            max_y = std::max(max_y, site.y);
+        }
+        const float extent_x = max_x - min_x;
+        const float extent_y = max_y - min_y;
+        // Square bins of about one site each; at most one bin per site along a degenerate axis
+        const float extent = std::max(extent_x, extent_y);
+        // A handful of sites share one bin: scanning them beats walking rings
+        const float n = static_cast<float>(sites.size());
+        bin_size = extent <= 0.0f ? 1.0f
+                 : sites.size() <= 16 ? extent * 2.0f
+                 : std::max(std::sqrt(extent_x * extent_y / n), extent / n);
+        bins_x = std::clamp(static_cast<int>(extent_x / bin_size) + 1, 1, 4096);
+        bins_y = std::clamp(static_cast<int>(extent_y / bin_size) + 1, 1, 4096);
+        bin_size = std::max({bin_size, extent_x / bins_x, extent_y / bins_y});
+        origin_x = min_x;
+        origin_y = min_y;
+
+        // Counting sort keeps sites in index order within each bin
+        bin_start.assign(static_cast<size_t>(bins_x) * bins_y + 1, 0);
+        std::vector<int> site_bins(sites.size());
+        for (size_t s = 0; s < sites.size(); ++s) {
+            site_bins[s] = bin_of(sites[s].x, sites[s].y);
+            ++bin_start[site_bins[s] + 1];
+        }
+        for (size_t b = 1; b < bin_start.size(); ++b) {
+            bin_start[b] += bin_start[b - 1];
+        }
+        bin_sites.resize(sites.size());
+        std::vector<int> cursor(bin_start.begin(), bin_start.end() - 1);
+        for (size_t s = 0; s < sites.size(); ++s) {
+            bin_sites[cursor[site_bins[s]]++] = static_cast<int>(s);
+        }
+    }
+
+    int bin_x(float x) const { return std::clamp(static_cast<int>(std::floor((x - origin_x) / bin_size)), 0, bins_x - 1); }
+    int bin_y(float y) const { return std::clamp(static_cast<int>(std::floor((y - origin_y) / bin_size)), 0, bins_y - 1); }
+    int bin_of(float x, float y) const { return bin_y(y) * bins_x + bin_x(x); }
+
+    // Nearest and second-nearest distance under metric(p, site), which must be at least the
+    // planar distance between p and site for the ring bound to hold
+    template <typename Metric>
+    void nearest_two(const Vec3& p, const std::vector<Vec3>& sites, Metric&& metric,
+                     float& first, float& second, int& first_site) const {
+        first = std::numeric_limits<float>::max();
+        second = std::numeric_limits<float>::max();
+        first_site = -1;
+        const int cx = bin_x(p.x);
+        const int cy = bin_y(p.y);
+        const int max_ring = std::max({cx, bins_x - 1 - cx, cy, bins_y - 1 - cy});
+        const float gap_x = std::max({0.0f, origin_x - p.x, p.x - (origin_x + bins_x * bin_size)});
+        const float gap_y = std::max({0.0f, origin_y - p.y, p.y - (origin_y + bins_y * bin_size)});
+
+        for (int ring = 0; ring <= max_ring; ++ring) {
+            const int y0 = cy - ring, y1 = cy + ring;
+            const int x0 = cx - ring, x1 = cx + ring;
+            auto visit = [&](int bx, int by) {
+                const int bin = by * bins_x + bx;
+                for (int n = bin_start[bin]; n < bin_start[bin + 1]; ++n) {
+                    const int site = bin_sites[n];
+                    const float d = metric(p, sites[site]);
+                    if (d < first || (d == first && site < first_site)) {
+                        second = first;
+                        first = d;
+                        first_site = site;
+                    } else if (d < second) {
+                        second = d;
+                    }
+                }
+            };
+            for (int by = std::max(0, y0); by <= std::min(bins_y - 1, y1); ++by) {
+                if (by == y0 || by == y1) {
+                    for (int bx = std::max(0, x0); bx <= std::min(bins_x - 1, x1); ++bx) visit(bx, by);
+                } else {
+                    if (x0 >= 0) visit(x0, by);
+                    if (x1 < bins_x && x1 != x0) visit(x1, by);
                 }
             }
 
-            // Voronoi edge distance (distance to second closest minus closest)
-            m_field_values[idx] = second_min_dist - min_dist;
+            // Unsearched bins lie beyond a side of the square that still has bins behind it and
+            // inside the grid, which p may lie outside of by gap_x / gap_y
+            float bound = std::numeric_limits<float>::max();
+            auto side = [&](float across, float gap) { bound = std::min(bound, std::sqrt(across * across + gap * gap)); };
+            if (x0 > 0) side(p.x - (origin_x + x0 * bin_size), gap_y);
+            if (x1 < bins_x - 1) side(origin_x + (x1 + 1) * bin_size - p.x, gap_y);
+            if (y0 > 0) side(p.y - (origin_y + y0 * bin_size), gap_x);
+            if (y1 < bins_y - 1) side(origin_y + (y1 + 1) * bin_size - p.y, gap_x);
+            if (second <= bound) break;
         }
     }
+};
+
+struct Segment {
+    Vec3 a, b;
+};
+
+// Planar distance from p to segment ab
+inline float segment_distance(const Vec3& p, const Vec3& a, const Vec3& b) {
+    const float abx = b.x - a.x, aby = b.y - a.y;
+    const float apx = p.x - a.x, apy = p.y - a.y;
+    const float len2 = abx * abx + aby * aby;
+    const float t = (len2 > 1e-12f) ? std::clamp((apx * abx + apy * aby) / len2, 0.0f, 1.0f) : 0.0f;
+    const float dx = apx - t * abx;
+    const float dy = apy - t * aby;
+    return std::sqrt(dx * dx + dy * dy);
 }
 
-void ScalarField2D::apply_scalar_line(const Vec3& start, const Vec3& end, float thickness) {
-    // Simple line SDF implementation
-    for (int j = 0; j < m_res_y; ++j) {
+// Bounding volume hierarchy over segments for nearest-segment distance queries. Nodes are split
+// at the median of the longer axis and searched nearer child first, skipping boxes farther away
+// than the best distance so far.
+struct SegmentBVH {
+    struct Node {
+        float min_x, min_y, max_x, max_y;
+        int first;      // leaf: first segment; inner: left child (right child is first + 1)
+        int count;      // segments in a leaf, 0 for inner nodes
+    };
+    static constexpr int LEAF_SIZE = 4;
+
+    std::vector<Segment> segments;      // reordered so every leaf holds a contiguous range
+    std::vector<Node> nodes;
+
+    explicit SegmentBVH(std::vector<Segment> segs) : segments(std::move(segs)) {
+        if (segments.empty()) {
+            return;
+        }
+        nodes.reserve(2 * segments.size() / LEAF_SIZE + 1);
+        nodes.push_back(Node());
+        build(0, 0, static_cast<int>(segments.size()));
+    }
+
+    // Distance from p to the nearest segment; upper must be at least that distance (such as the
+    // distance of a neighbouring point plus the step to it) and only serves to prune early
+    float distance(const Vec3& p, float upper = std::numeric_limits<float>::max()) const {
+        float best = std::numeric_limits<float>::max();
+        if (nodes.empty()) {
+            return best;
+        }
+        // Slack keeps rounding in upper from pruning the segment that attains it
+        float limit = upper < std::numeric_limits<float>::max() ? upper * 1.0001f + 1e-6f : upper;
+        float limit2 = limit < std::numeric_limits<float>::max() ? limit * limit : limit;
+        int stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (box_distance2(node, p) > limit2) continue;
+            if (node.count > 0) {
+                for (int n = node.first; n < node.first + node.count; ++n) {
+                    const float d = segment_distance(p, segments[n].a, segments[n].b);
+                    if (d < best) {
+                        best = d;
+                        if (d < limit) {
+                            limit = d;
+                            limit2 = d * d;
+                        }
+                    }
+                }
+            } else {
+                const float d_left = box_distance2(nodes[node.first], p);
+                const float d_right = box_distance2(nodes[node.first + 1], p);
+                // Push the farther child first so the nearer one is searched first
+                stack[top++] = d_left < d_right ? node.first + 1 : node.first;
+                stack[top++] = d_left < d_right ? node.first : node.first + 1;
+            }
+        }
+        return best;
+    }
+
+private:
+    static float box_distance2(const Node& node, const Vec3& p) {
+        const float dx = std::max({node.min_x - p.x, 0.0f, p.x - node.max_x});
+        const float dy = std::max({node.min_y - p.y, 0.0f, p.y - node.max_y});
+        return dx * dx + dy * dy;
+    }
+
+    void build(int index, int begin, int end) {
+        Node node;
+        node.min_x = node.min_y = std::numeric_limits<float>::max();
+        node.max_x = node.max_y = std::numeric_limits<float>::lowest();
+        for (int n = begin; n < end; ++n) {
+            const Segment& s = segments[n];
+            node.min_x = std::min({node.min_x, s.a.x, s.b.x});
+            node.min_y = std::min({node.min_y, s.a.y, s.b.y});
+            node.max_x = std::max({node.max_x, s.a.x, s.b.x});
+            node.max_y = std::max({node.max_y, s.a.y, s.b.y});
+        }
+        if (end - begin <= LEAF_SIZE) {
+            node.first = begin;
+            node.count = end - begin;
+            nodes[index] = node;
+            return;
+        }
+
+        const bool split_x = node.max_x - node.min_x >= node.max_y - node.min_y;
+        const int mid = begin + (end - begin) / 2;
+        std::nth_element(segments.begin() + begin, segments.begin() + mid, segments.begin() + end,
+            [split_x](const Segment& l, const Segment& r) {
+                return split_x ? l.a.x + l.b.x < r.a.x + r.b.x : l.a.y + l.b.y < r.a.y + r.b.y;
+            });
+        node.first = static_cast<int>(nodes.size());
+        node.count = 0;
+        nodes[index] = node;
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        build(node.first, begin, mid);
+        build(node.first + 1, mid, end);
+    }
+};
+
+// Closed rings (at least three vertices each) as edge lists
+std::vector<Segment> ring_edges(const std::vector<std::vector<Vec3>>& rings) {
+    std::vector<Segment> edges;
+    for (const std::vector<Vec3>& ring : rings) {
+        if (ring.size() < 3) continue;
+        for (size_t k = 0, n = ring.size(); k < n; ++k) {
+            edges.push_back({ring[k], ring[(k + 1) % n]});
+        }
+    }
+    return edges;
+}
+
+// Scanline even-odd test for one grid row. The row's points lie on a line, so the edges crossing
+// that line are found once and sorted along it; a point is inside when an odd number of crossings
+// lie ahead of it, which is the ray cast of every point in a single pass.
+void row_inside(const std::vector<Vec3>& points, const std::vector<Segment>& edges,
+                std::vector<float>& crossings, std::vector<char>& inside) {
+    const Vec3 origin = points.front();
+    float dx = points.back().x - origin.x, dy = points.back().y - origin.y;
+    if (dx * dx + dy * dy < 1e-20f) {
+        dx = 1.0f;
+        dy = 0.0f;
+    }
+    auto side = [&](const Vec3& v) { return dx * (v.y - origin.y) - dy * (v.x - origin.x); };
+    auto along = [&](float x, float y) { return (x - origin.x) * dx + (y - origin.y) * dy; };
+
+    crossings.clear();
+    for (const Segment& e : edges) {
+        const float sa = side(e.a), sb = side(e.b);
+        if ((sa > 0.0f) != (sb > 0.0f)) {
+            const float t = sa / (sa - sb);
+            crossings.push_back(along(e.a.x + (e.b.x - e.a.x) * t, e.a.y + (e.b.y - e.a.y) * t));
+        }
+    }
+    std::sort(crossings.begin(), crossings.end());
+
+    inside.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const float t = along(points[i].x, points[i].y);
+        const auto ahead = crossings.end() - std::upper_bound(crossings.begin(), crossings.end(), t);
+        inside[i] = (ahead & 1) != 0;
+    }
+}
+
+} // namespace
+
+void ScalarField2D::apply_scalar_voronoi(const std::vector<Vec3>& sites) {
+    std::vector<int> site_ids;
+    apply_scalar_voronoi(sites, site_ids);
+}
+
+// Sites are indexed in a uniform grid, so each point looks at the few bins around it instead of
+// every site. Rows run in parallel; site_ids receives the nearest site of each point.
+void ScalarField2D::apply_scalar_voronoi(const std::vector<Vec3>& sites, std::vector<int>& site_ids) {
+    const SiteGrid grid(sites);
+    site_ids.resize(m_field_values.size());
+    parallel_for(m_res_y, 0, [&](int j) {
         for (int i = 0; i < m_res_x; ++i) {
             const int idx = get_index(i, j);
-            const Vec3& pt = m_grid_points[idx];
+            float min_dist, second_min_dist;
+            grid.nearest_two(grid_point(i, j), sites, [](const Vec3& p, const Vec3& site) {
+                return ScalarFieldUtils::distance_to(p, site);
+            }, min_dist, second_min_dist, site_ids[idx]);
 
-            const Vec3 pa = pt - start;
-            const Vec3 ba = end - start;
-            const float h = clamp(pa.dot(ba) / ba.dot(ba), 0.0f, 1.0f);
-            const float dist = (pa - ba * h).length();
+            // Voronoi edge distance (distance to second closest minus closest)
+            m_field_values[idx] = second_min_dist - min_dist;
+        }
+    });
+    on_values_changed();
+}
 
-            m_field_values[idx] = dist - thickness; // SDF: negative inside, positive outside
+void ScalarField2D::apply_scalar_line(const Vec3& start, const Vec3& end, float thickness) {
+    apply_scalar_polylines({{start, end}}, thickness);
+}
+
+// Distance to the nearest segment of any polyline, looked up in a segment BVH; rows in parallel
+void ScalarField2D::apply_scalar_polylines(const std::vector<std::vector<Vec3>>& polylines, float thickness) {
+    std::vector<Segment> segments;
+    for (const std::vector<Vec3>& polyline : polylines) {
+        for (size_t k = 0; k + 1 < polyline.size(); ++k) {
+            segments.push_back({polyline[k], polyline[k + 1]});
+        }
+        if (polyline.size() == 1) {
+            segments.push_back({polyline[0], polyline[0]});
         }
     }
+    if (segments.empty()) return;
+
+    const SegmentBVH bvh(std::move(segments));
+    parallel_for(m_res_y, 0, [&](int j) {
+        Vec3 previous;
+        float dist = std::numeric_limits<float>::max();
+        for (int i = 0; i < m_res_x; ++i) {
+            const Vec3 pt = grid_point(i, j);
+            // The previous point's distance plus the step bounds this one
+            dist = bvh.distance(pt, i > 0 ? dist + ScalarFieldUtils::distance_to(pt, previous) : dist);
+            previous = pt;
+            m_field_values[get_index(i, j)] = dist - thickness; // SDF: negative inside, positive outside
+        }
+    });
     m_has_valid_sdf = true;
+    on_values_changed();
 }
 
 void ScalarField2D::apply_scalar_polygon(const std::vector<Vec3>& vertices) {
     if (vertices.size() < 3) return;
 
-    auto pointInPolygon = [](float px, float py, const std::vector<Vec3>& verts) {
-        bool inside = false;
-        const size_t n = verts.size();
-        for (size_t i = 0, j = n - 1; i < n; j = i++) {
-            const float xi = verts[i].x;
-            const float yi = verts[i].y;
-            const float xj = verts[j].x;
-            const float yj = verts[j].y;
-            const bool intersect =
-                ((yi > py) != (yj > py)) &&
-                (px < (xj - xi) * (py - yi) / ((yj - yi) + 1e-8f) + xi);
-            if (intersect) inside = !inside;
-        }
-        return inside;
-    };
+    double area = 0.0;
+    const size_t n = vertices.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++) {
+        area += double(vertices[j].x) * double(vertices[i].y) -
+                double(vertices[i].x) * double(vertices[j].y);
+    }
+    apply_rings_sdf({vertices}, area < 0.0);
+}
 
-    auto segmentDistance = [](const Vec3& p, const Vec3& a, const Vec3& b) {
-        const Vec3 ab = b - a;
-        const Vec3 ap = p - a;
-        const float len2 = ab.x * ab.x + ab.y * ab.y;
-        float t = (len2 > 1e-12f) ? ((ap.x * ab.x + ap.y * ab.y) / len2) : 0.0f;
-        t = std::clamp(t, 0.0f, 1.0f);
-        const float cx = a.x + t * ab.x;
-        const float cy = a.y + t * ab.y;
-        const float dx = p.x - cx;
-        const float dy = p.y - cy;
-        return std::sqrt(dx * dx + dy * dy);
-    };
+void ScalarField2D::apply_scalar_polygons(const std::vector<std::vector<Vec3>>& rings) {
+    apply_rings_sdf(rings, false);
+}
 
-    auto signedArea = [](const std::vector<Vec3>& verts) {
-        double area = 0.0;
-        const size_t n = verts.size();
-        for (size_t i = 0, j = n - 1; i < n; j = i++) {
-            area += double(verts[j].x) * double(verts[i].y) -
-                    double(verts[i].x) * double(verts[j].y);
-        }
-        return float(0.5 * area);
-    };
+// Signed distance to the even-odd region of the rings: distances come from a segment BVH, the
+// inside test from one scanline pass per row. A hole is the complement of its region and is
+// subtracted from the field; otherwise the region is unioned with it (or replaces it if the
+// field holds no SDF yet).
+void ScalarField2D::apply_rings_sdf(const std::vector<std::vector<Vec3>>& rings, bool is_hole) {
+    const std::vector<Segment> edges = ring_edges(rings);
+    if (edges.empty()) return;
 
-    const float area = signedArea(vertices);
-    const bool isHole = area < 0.0f;
+    const SegmentBVH bvh(edges);
     const bool firstPolygon = !m_has_valid_sdf;
+    parallel_for(m_res_y, 0, [&](int j) {
+        std::vector<Vec3> points(m_res_x);
+        std::vector<float> crossings;
+        std::vector<char> inside;
+        for (int i = 0; i < m_res_x; ++i) {
+            points[i] = grid_point(i, j);
+        }
+        row_inside(points, edges, crossings, inside);
 
-    for (int j = 0; j < m_res_y; ++j) {
+        float minDist = std::numeric_limits<float>::max();
         for (int i = 0; i < m_res_x; ++i) {
             const int idx = get_index(i, j);
-            const Vec3& pt = m_grid_points[idx];
-
-            float minDist = std::numeric_limits<float>::max();
-            for (size_t k = 0, n = vertices.size(); k < n; ++k) {
-                const Vec3& a = vertices[k];
-                const Vec3& b = vertices[(k + 1) % n];
-                minDist = std::min(minDist, segmentDistance(pt, a, b));
-            }
-
-            const bool inside = pointInPolygon(pt.x, pt.y, vertices);
-            float sdf = inside ? -minDist : minDist;
-            if (isHole) sdf = -sdf;
+            minDist = bvh.distance(points[i], i > 0 ? minDist + ScalarFieldUtils::distance_to(points[i], points[i - 1]) : minDist);
+            float sdf = inside[i] ? -minDist : minDist;
+            if (is_hole) sdf = -sdf;
 
             if (firstPolygon) {
                 m_field_values[idx] = sdf;
+            } else if (is_hole) {
+                m_field_values[idx] = std::max(m_field_values[idx], sdf);
             } else {
-                if (isHole) {
-                    m_field_values[idx] = std::max(m_field_values[idx], sdf);
-                } else {
-                    m_field_values[idx] = std::min(m_field_values[idx], sdf);
-                }
+                m_field_values[idx] = std::min(m_field_values[idx], sdf);
             }
         }
-    }
+    });
 
     m_has_valid_sdf = true;
+    on_values_changed();
 }
 
 void ScalarField2D::apply_scalar_ellipse(const Vec3 &center, float radiusX, float radiusY, const float rotation)
@@ -337,7 +634,7 @@ void ScalarField2D::apply_scalar_ellipse(const Vec3 &center, float radiusX, floa
     for (int j = 0; j < m_res_y; ++j) {
         for (int i = 0; i < m_res_x; ++i) {
             int idx = get_index(i, j);
-            Vec3 p = m_grid_points[idx] - center;
+            Vec3 p = grid_point(i, j) - center;
             // Rotate the point around the center by -rotation to align major axis
             float xRot = p.x * cosR - p.y * sinR;
             float yRot = p.x * sinR + p.y * cosR;
@@ -349,26 +646,48 @@ void ScalarField2D::apply_scalar_ellipse(const Vec3 &center, float radiusX, floa
         }
     }
     m_has_valid_sdf = true;
+    on_values_changed();
 }
 
 void ScalarField2D::apply_scalar_manhattan_voronoi(const std::vector<Vec3> &sites)
 {
-    for (int j = 0; j < m_res_y; ++j)
-    {
-        for (int i = 0; i < m_res_x; ++i)
-        {
-            int idx = get_index(i, j);
-            const Vec3 &p = m_grid_points[idx];
-            float minDist = std::numeric_limits<float>::max();
-            for (const auto &site : sites)
-            {
-                float d = std::abs(p.x - site.x) + std::abs(p.y - site.y);
-                if (d < minDist)
-                    minDist = d;
-            }
+    std::vector<int> site_ids;
+    apply_scalar_manhattan_voronoi(sites, site_ids);
+}
+
+// Same site index as apply_scalar_voronoi; the L1 distance is never below the planar distance
+void ScalarField2D::apply_scalar_manhattan_voronoi(const std::vector<Vec3> &sites, std::vector<int> &site_ids)
+{
+    const SiteGrid grid(sites);
+    site_ids.resize(m_field_values.size());
+    parallel_for(m_res_y, 0, [&](int j) {
+        for (int i = 0; i < m_res_x; ++i) {
+            const int idx = get_index(i, j);
+            float minDist, secondDist;
+            grid.nearest_two(grid_point(i, j), sites, [](const Vec3& p, const Vec3& site) {
+                return std::abs(p.x - site.x) + std::abs(p.y - site.y);
+            }, minDist, secondDist, site_ids[idx]);
             m_field_values[idx] = minDist;
         }
-    }
+    });
+    on_values_changed();
+}
+
+
+// Fused single-pass evaluation; rows are independent tasks evaluated in batches
+void ScalarField2D::apply_sdf(const SdfExpression& expression) {
+    parallel_for(m_res_y, 0, [&](int j) {
+        std::vector<float> xs(m_res_x), ys(m_res_x), zs(m_res_x), scratch;
+        for (int i = 0; i < m_res_x; ++i) {
+            const Vec3 pt = grid_point(i, j);
+            xs[i] = pt.x;
+            ys[i] = pt.y;
+            zs[i] = pt.z;
+        }
+        expression.evaluate(xs.data(), ys.data(), zs.data(), m_res_x, &m_field_values[get_index(0, j)], scratch);
+    });
+    m_has_valid_sdf = true;
+    on_values_changed();
 }
 
 
@@ -381,6 +700,7 @@ void ScalarField2D::boolean_union(const ScalarField2D& other) {
     for (size_t i = 0; i < m_field_values.size(); ++i) {
         m_field_values[i] = std::min(m_field_values[i], other.m_field_values[i]);
     }
+    on_values_changed();
 }
 
 void ScalarField2D::boolean_intersect(const ScalarField2D& other) {
@@ -391,6 +711,7 @@ void ScalarField2D::boolean_intersect(const ScalarField2D& other) {
     for (size_t i = 0; i < m_field_values.size(); ++i) {
         m_field_values[i] = std::max(m_field_values[i], other.m_field_values[i]);
     }
+    on_values_changed();
 }
 
 void ScalarField2D::boolean_inverseintersect(const ScalarField2D &other)
@@ -404,6 +725,7 @@ void ScalarField2D::boolean_inverseintersect(const ScalarField2D &other)
     {
         m_field_values[i] = std::min(m_field_values[i], -other.m_field_values[i]);
     }
+    on_values_changed();
 }
 
 void ScalarField2D::boolean_subtract(const ScalarField2D& other) {
@@ -414,6 +736,7 @@ void ScalarField2D::boolean_subtract(const ScalarField2D& other) {
     for (size_t i = 0; i < m_field_values.size(); ++i) {
         m_field_values[i] = std::max(m_field_values[i], -other.m_field_values[i]);
     }
+    on_values_changed();
 }
 
 void ScalarField2D::boolean_smin(const ScalarField2D& other, float smoothing) {
@@ -424,6 +747,7 @@ void ScalarField2D::boolean_smin(const ScalarField2D& other, float smoothing) {
     for (size_t i = 0; i < m_field_values.size(); ++i) {
         m_field_values[i] = ScalarFieldUtils::smooth_min(m_field_values[i], other.m_field_values[i], smoothing);
     }
+    on_values_changed();
 }
 
 void ScalarField2D::boolean_smin_weighted(const ScalarField2D& other, float smoothing, float wt) {
@@ -434,6 +758,7 @@ void ScalarField2D::boolean_smin_weighted(const ScalarField2D& other, float smoo
     for (size_t i = 0; i < m_field_values.size(); ++i) {
         m_field_values[i] = ScalarFieldUtils::smooth_min_weighted(m_field_values[i], other.m_field_values[i], smoothing, wt);
     }
+    on_values_changed();
 }
 
 void ScalarField2D::interpolate(const ScalarField2D& other, float t) {
@@ -444,6 +769,7 @@ void ScalarField2D::interpolate(const ScalarField2D& other, float t) {
     for (size_t i = 0; i < m_field_values.size(); ++i) {
         m_field_values[i] = (1.0f - t) * m_field_values[i] + t * other.m_field_values[i];
     }
+    on_values_changed();
 }
 
 // Rendering methods
@@ -461,7 +787,7 @@ void ScalarField2D::draw_points(Renderer& renderer, int step) const {
             ScalarFieldUtils::get_hsv_color(f, r, g, b);
             const Color color(r, g, b);
 
-            renderer.drawPoint(m_grid_points[idx], color, 3.0f);
+            renderer.drawPoint(grid_point(i, j), color, 3.0f);
         }
     }
 }
@@ -474,112 +800,332 @@ void ScalarField2D::draw_values(Renderer& renderer, int step) const {
 
             // Draw 3D text showing the scalar value
             const std::string text = std::to_string(value).substr(0, 5); // Limit to 5 characters
-            renderer.drawText(text, m_grid_points[idx] + Vec3(0, 0, 0), 0.8f);
+            renderer.drawText(text, grid_point(i, j), 0.8f);
         }
     }
 }
 
-// Legacy compatibility method for contour drawing
+// Legacy compatibility method for contour drawing: the cached segments go out in one batch
 void ScalarField2D::drawIsocontours(Renderer& renderer, float threshold) const {
-    GraphObject contours = get_contours(threshold);
-    auto data = contours.getGraphData();
-    if (!data) {
+    const std::shared_ptr<const std::vector<Vec3>> segments = get_contour_segments(threshold);
+    if (segments->empty()) {
         return;
     }
 
-    for (const auto& edge : data->edges) {
-        if (edge.vertexA < 0 || edge.vertexB < 0 ||
-            edge.vertexA >= static_cast<int>(data->vertices.size()) ||
-            edge.vertexB >= static_cast<int>(data->vertices.size())) {
-            continue;
+    const float oldWidth = renderer.getLineWidth();
+    renderer.setLineWidth(2.0f);
+    renderer.drawLines(segments->data(), static_cast<int>(segments->size()));
+    renderer.setLineWidth(oldWidth);
+}
+
+// Hits cost a lookup. A stale entry for the threshold gets a new buffer; a new threshold takes
+// a free slot or the least recently built entry. Buffers handed out earlier are left untouched.
+std::shared_ptr<const std::vector<Vec3>> ScalarField2D::get_contour_segments(float threshold) const {
+    ContourLines* entry = nullptr;
+    for (ContourLines& cached : m_contour_cache) {
+        if (cached.threshold == threshold) {
+            if (cached.version == m_version) {
+                return cached.segments;
+            }
+            entry = &cached;
+            break;
         }
+    }
+    if (!entry) {
+        if (m_contour_cache.size() < CONTOUR_CACHE_SIZE) {
+            entry = &m_contour_cache.emplace_back();
+        } else {
+            entry = &*std::min_element(m_contour_cache.begin(), m_contour_cache.end(),
+                [](const ContourLines& a, const ContourLines& b) { return a.version < b.version; });
+        }
+    }
 
-        const Vec3& start = data->vertices[edge.vertexA].position;
-        const Vec3& end = data->vertices[edge.vertexB].position;
-        renderer.drawLine(start, end, renderer.getCurrentColor(), 2.0f);
+    auto segments = std::make_shared<std::vector<Vec3>>();
+    for (const ContourPolyline& polyline : get_contour_polylines(threshold)) {
+        const std::vector<Vec3>& points = polyline.points;
+        for (size_t k = 0; k + 1 < points.size(); ++k) {
+            segments->push_back(points[k]);
+            segments->push_back(points[k + 1]);
+        }
+        if (polyline.closed && points.size() > 1) {
+            segments->push_back(points.back());
+            segments->push_back(points.front());
+        }
     }
+    entry->threshold = threshold;
+    entry->version = m_version;
+    entry->segments = std::move(segments);
+    return entry->segments;
 }
 
-// Analysis methods - simplified implementations
-GraphObject ScalarField2D::get_contours(float threshold) const {
-    GraphObject graph("ScalarFieldContours");
-    auto data = graph.getGraphData();
-    if (!data) {
-        return graph;
+namespace {
+
+// Marching squares segments per cell case, oriented with the side below the threshold on the
+// left. Corner k of cell (i, j) is (i, j), (i + 1, j), (i + 1, j + 1), (i, j + 1) for k = 0..3 and
+// bit k of the case is set when corner k lies below the threshold; edge k runs from corner k to
+// corner k + 1. Entries are (from edge, to edge) pairs. The saddles 5 and 10 keep the corners
+// below the threshold apart; SADDLE_JOINED connects them when the cell centre is below too.
+constexpr int8_t CONTOUR_SEGMENTS[16][4] = {
+    {-1, -1, -1, -1}, { 0,  3, -1, -1}, { 1,  0, -1, -1}, { 1,  3, -1, -1},
+    { 2,  1, -1, -1}, { 0,  3,  2,  1}, { 2,  0, -1, -1}, { 2,  3, -1, -1},
+    { 3,  2, -1, -1}, { 0,  2, -1, -1}, { 1,  0,  3,  2}, { 1,  2, -1, -1},
+    { 3,  1, -1, -1}, { 0,  1, -1, -1}, { 3,  0, -1, -1}, {-1, -1, -1, -1}
+};
+constexpr int8_t SADDLE_JOINED[2][4] = {{0, 1, 2, 3}, {3, 0, 1, 2}};    // cases 5 and 10
+
+// Open polylines start where no segment enters; whatever remains forms closed loops
+std::vector<ContourPolyline> chain_polylines(const std::vector<Vec3>& positions, const std::vector<int>& next,
+                                             const std::vector<char>& has_prev) {
+    std::vector<ContourPolyline> polylines;
+    std::vector<char> visited(positions.size(), 0);
+    auto walk = [&](int start, bool closed) {
+        ContourPolyline& polyline = polylines.emplace_back();
+        polyline.closed = closed;
+        for (int v = start; v >= 0 && !visited[v]; v = next[v]) {
+            visited[v] = 1;
+            polyline.points.push_back(positions[v]);
+        }
+    };
+    for (int v = 0; v < static_cast<int>(positions.size()); ++v) {
+        if (!has_prev[v]) walk(v, false);
+    }
+    for (int v = 0; v < static_cast<int>(positions.size()); ++v) {
+        if (!visited[v]) walk(v, true);
+    }
+    return polylines;
+}
+
+} // namespace
+
+Vec3 ScalarField2D::contour_crossing(int i0, int j0, int i1, int j1, float threshold) const {
+    const float a = m_field_values[get_index(i0, j0)];
+    const float b = m_field_values[get_index(i1, j1)];
+    const float denom = b - a;
+    const float t = (std::abs(denom) > 1e-6f) ? (threshold - a) / denom : 0.5f;
+    return Vec3::lerp(grid_point(i0, j0), grid_point(i1, j1), t);
+}
+
+const int8_t* ScalarField2D::contour_cell_segments(int i, int j, float threshold) const {
+    const float v00 = m_field_values[get_index(i, j)];
+    const float v10 = m_field_values[get_index(i + 1, j)];
+    const float v11 = m_field_values[get_index(i + 1, j + 1)];
+    const float v01 = m_field_values[get_index(i, j + 1)];
+    const int cell_case = (v00 < threshold) | (v10 < threshold) << 1 | (v11 < threshold) << 2 | (v01 < threshold) << 3;
+    if (cell_case == 0 || cell_case == 15) {
+        return nullptr;
+    }
+    if ((cell_case == 5 || cell_case == 10) && (v00 + v10 + v11 + v01) * 0.25f < threshold) {
+        return SADDLE_JOINED[cell_case == 10];
+    }
+    return CONTOUR_SEGMENTS[cell_case];
+}
+
+// Each grid edge gets at most one crossing, numbered row by row and computed once, so the two
+// cells sharing an edge refer to the same vertex without any lookup. Every crossing is left by
+// exactly one oriented segment and entered by at most one, so chaining follows a next[] array.
+// Rows are independent in all passes but the final walk.
+std::vector<ContourPolyline> ScalarField2D::get_contour_polylines(float threshold) const {
+    if (m_res_x < 2 || m_res_y < 2) {
+        return {};
     }
 
-    struct VecKey {
-        int x;
-        int y;
-        int z;
+    // Crossing ids of horizontal edges (i, j)-(i + 1, j) and vertical edges (i, j)-(i, j + 1)
+    const int h_stride = m_res_x - 1;
+    std::vector<int> h_ids(static_cast<size_t>(m_res_y) * h_stride, -1);
+    std::vector<int> v_ids(static_cast<size_t>(m_res_y - 1) * m_res_x, -1);
+    auto below = [&](int i, int j) { return m_field_values[get_index(i, j)] < threshold; };
 
-        bool operator==(const VecKey& other) const {
-            return x == other.x && y == other.y && z == other.z;
+    // Count crossings per row, then number and place them
+    std::vector<int> row_start(m_res_y + 1, 0);
+    parallel_for(m_res_y, 0, [&](int j) {
+        int count = 0;
+        for (int i = 0; i < m_res_x; ++i) {
+            if (i + 1 < m_res_x && below(i, j) != below(i + 1, j)) ++count;
+            if (j + 1 < m_res_y && below(i, j) != below(i, j + 1)) ++count;
         }
-    };
+        row_start[j + 1] = count;
+    });
+    for (int j = 0; j < m_res_y; ++j) {
+        row_start[j + 1] += row_start[j];
+    }
+
+    std::vector<Vec3> positions(row_start[m_res_y]);
+    parallel_for(m_res_y, 0, [&](int j) {
+        int id = row_start[j];
+        for (int i = 0; i < m_res_x; ++i) {
+            if (i + 1 < m_res_x && below(i, j) != below(i + 1, j)) {
+                positions[id] = contour_crossing(i, j, i + 1, j, threshold);
+                h_ids[j * h_stride + i] = id++;
+            }
+            if (j + 1 < m_res_y && below(i, j) != below(i, j + 1)) {
+                positions[id] = contour_crossing(i, j, i, j + 1, threshold);
+                v_ids[j * m_res_x + i] = id++;
+            }
+        }
+    });
 
-    struct VecKeyHash {
-        std::size_t operator()(const VecKey& key) const {
-            std::size_t h1 = std::hash<int>{}(key.x);
-            std::size_t h2 = std::hash<int>{}(key.y);
-            std::size_t h3 = std::hash<int>{}(key.z);
-            return h1 ^ (h2 << 1) ^ (h3 << 2);
+    // Link the oriented segments of every cell
+    std::vector<int> next(positions.size(), -1);
+    std::vector<char> has_prev(positions.size(), 0);
+    parallel_for(m_res_y - 1, 0, [&](int j) {
+        for (int i = 0; i < m_res_x - 1; ++i) {
+            const int8_t* table = contour_cell_segments(i, j, threshold);
+            if (!table) continue;
+
+            const int edge_ids[4] = {h_ids[j * h_stride + i], v_ids[j * m_res_x + i + 1],
+                                     h_ids[(j + 1) * h_stride + i], v_ids[j * m_res_x + i]};
+            for (int s = 0; s < 4 && table[s] >= 0; s += 2) {
+                next[edge_ids[table[s]]] = edge_ids[table[s + 1]];
+                has_prev[edge_ids[table[s + 1]]] = 1;
+            }
         }
-    };
+    });
 
-    const float quantizeScale = 10000.0f;
-    std::unordered_map<VecKey, int, VecKeyHash> vertexLookup;
+    return chain_polylines(positions, next, has_prev);
+}
 
-    auto getOrCreateVertex = [&](const Vec3& position) -> int {
-        VecKey key{
-            static_cast<int>(std::round(position.x * quantizeScale)),
-            static_cast<int>(std::round(position.y * quantizeScale)),
-            static_cast<int>(std::round(position.z * quantizeScale))
-        };
+// The interval index maps every cell to the run of sorted thresholds its value range spans
+// (min < t <= max), stored per threshold as a list of cells. Each level then numbers the crossings
+// of its own cells only, in the same row-major edge order as get_contour_polylines, so results
+// are identical to contouring each level on its own. Levels run in parallel, each worker reusing
+// one set of per-edge scratch arrays that it resets cell by cell.
+std::vector<std::vector<ContourPolyline>> ScalarField2D::get_contours_multi(std::span<const float> thresholds) const {
+    std::vector<std::vector<ContourPolyline>> results(thresholds.size());
+    if (m_res_x < 2 || m_res_y < 2 || thresholds.empty()) {
+        return results;
+    }
 
-        if (auto it = vertexLookup.find(key); it != vertexLookup.end()) {
-            return it->second;
+    const int level_count = static_cast<int>(thresholds.size());
+    std::vector<int> order(level_count);
+    for (int k = 0; k < level_count; ++k) order[k] = k;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return thresholds[a] < thresholds[b]; });
+    std::vector<float> levels(level_count);
+    for (int k = 0; k < level_count; ++k) levels[k] = thresholds[order[k]];
+
+    // Sorted level range [first, last) of every cell, then cells per level in index order
+    const int cells_x = m_res_x - 1;
+    const int cell_count = cells_x * (m_res_y - 1);
+    std::vector<int> first_level(cell_count), last_level(cell_count);
+    parallel_for(m_res_y - 1, 0, [&](int j) {
+        for (int i = 0; i < cells_x; ++i) {
+            const float v00 = m_field_values[get_index(i, j)];
+            const float v10 = m_field_values[get_index(i + 1, j)];
+            const float v01 = m_field_values[get_index(i, j + 1)];
+            const float v11 = m_field_values[get_index(i + 1, j + 1)];
+            const int cell = j * cells_x + i;
+            first_level[cell] = static_cast<int>(std::upper_bound(levels.begin(), levels.end(), std::min({v00, v10, v01, v11})) - levels.begin());
+            last_level[cell] = static_cast<int>(std::upper_bound(levels.begin(), levels.end(), std::max({v00, v10, v01, v11})) - levels.begin());
         }
+    });
+    std::vector<int> level_start(level_count + 1, 0);
+    for (int cell = 0; cell < cell_count; ++cell) {
+        for (int k = first_level[cell]; k < last_level[cell]; ++k) ++level_start[k + 1];
+    }
+    for (int k = 0; k < level_count; ++k) {
+        level_start[k + 1] += level_start[k];
+    }
+    std::vector<int> level_cells(level_start[level_count]);
+    std::vector<int> cursor(level_start.begin(), level_start.end() - 1);
+    for (int cell = 0; cell < cell_count; ++cell) {
+        for (int k = first_level[cell]; k < last_level[cell]; ++k) level_cells[cursor[k]++] = cell;
+    }
 
-        int index = data->addVertex(position);
-        vertexLookup.emplace(key, index);
-        return index;
-    };
+    const int h_stride = m_res_x - 1;
+    const int workers = std::min(resolve_thread_count(0), level_count);
+    std::atomic<int> next_level{0};
+    parallel_for(workers, workers, [&](int) {
+        std::vector<int> h_ids(static_cast<size_t>(m_res_y) * h_stride, -1);
+        std::vector<int> v_ids(static_cast<size_t>(m_res_y - 1) * m_res_x, -1);
+        std::vector<int> edge_keys;     // 2 * point index, plus 1 for vertical edges
+        std::vector<Vec3> positions;
+        std::vector<int> next;
+        std::vector<char> has_prev;
+
+        for (int k = next_level++; k < level_count; k = next_level++) {
+            const float threshold = levels[k];
+            const int* cells = level_cells.data() + level_start[k];
+            const int count = level_start[k + 1] - level_start[k];
+            auto below = [&](int i, int j) { return m_field_values[get_index(i, j)] < threshold; };
+            auto cell_edges = [&](int cell, int* ids[4]) {
+                const int i = cell % cells_x, j = cell / cells_x;
+                ids[0] = &h_ids[j * h_stride + i];
+                ids[1] = &v_ids[j * m_res_x + i + 1];
+                ids[2] = &h_ids[(j + 1) * h_stride + i];
+                ids[3] = &v_ids[j * m_res_x + i];
+            };
+
+            // Collect the crossed edges of the level's cells once each, in row-major edge order
+            edge_keys.clear();
+            for (int n = 0; n < count; ++n) {
+                const int i = cells[n] % cells_x, j = cells[n] / cells_x;
+                int* ids[4];
+                cell_edges(cells[n], ids);
+                const int keys[4] = {2 * get_index(i, j), 2 * get_index(i + 1, j) + 1,
+                                     2 * get_index(i, j + 1), 2 * get_index(i, j) + 1};
+                const bool crossed[4] = {below(i, j) != below(i + 1, j), below(i + 1, j) != below(i + 1, j + 1),
+                                         below(i, j + 1) != below(i + 1, j + 1), below(i, j) != below(i, j + 1)};
+                for (int e = 0; e < 4; ++e) {
+                    if (crossed[e] && *ids[e] < 0) {
+                        *ids[e] = 0;
+                        edge_keys.push_back(keys[e]);
+                    }
+                }
+            }
+            std::sort(edge_keys.begin(), edge_keys.end());
+
+            positions.resize(edge_keys.size());
+            for (size_t id = 0; id < edge_keys.size(); ++id) {
+                const int point = edge_keys[id] / 2;
+                const int i = point % m_res_x, j = point / m_res_x;
+                const bool vertical = edge_keys[id] & 1;
+                positions[id] = vertical ? contour_crossing(i, j, i, j + 1, threshold) : contour_crossing(i, j, i + 1, j, threshold);
+                (vertical ? v_ids[j * m_res_x + i] : h_ids[j * h_stride + i]) = static_cast<int>(id);
+            }
 
-    auto addCrossing = [&](float valueA, float valueB, const Vec3& pointA, const Vec3& pointB, std::vector<Vec3>& crossings) {
-        if ((valueA < threshold && valueB >= threshold) || (valueB < threshold && valueA >= threshold)) {
-            float denom = valueB - valueA;
-            float t = (std::abs(denom) > 1e-6f) ? (threshold - valueA) / denom : 0.5f;
-            crossings.push_back(Vec3::lerp(pointA, pointB, t));
-        }
-    };
+            next.assign(positions.size(), -1);
+            has_prev.assign(positions.size(), 0);
+            for (int n = 0; n < count; ++n) {
+                int* ids[4];
+                cell_edges(cells[n], ids);
+                const int8_t* table = contour_cell_segments(cells[n] % cells_x, cells[n] / cells_x, threshold);
+                for (int s = 0; table && s < 4 && table[s] >= 0; s += 2) {
+                    next[*ids[table[s]]] = *ids[table[s + 1]];
+                    has_prev[*ids[table[s + 1]]] = 1;
+                }
+            }
+            results[order[k]] = chain_polylines(positions, next, has_prev);
 
-    for (int j = 0; j < m_res_y - 1; ++j) {
-        for (int i = 0; i < m_res_x - 1; ++i) {
-            const int idx00 = get_index(i, j);
-            const int idx10 = get_index(i + 1, j);
-            const int idx01 = get_index(i, j + 1);
-            const int idx11 = get_index(i + 1, j + 1);
-
-            const float v00 = m_field_values[idx00];
-            const float v10 = m_field_values[idx10];
-            const float v01 = m_field_values[idx01];
-            const float v11 = m_field_values[idx11];
-
-            std::vector<Vec3> crossings;
-            crossings.reserve(4);
-
-            addCrossing(v00, v10, m_grid_points[idx00], m_grid_points[idx10], crossings);
-            addCrossing(v10, v11, m_grid_points[idx10], m_grid_points[idx11], crossings);
-            addCrossing(v11, v01, m_grid_points[idx11], m_grid_points[idx01], crossings);
-            addCrossing(v01, v00, m_grid_points[idx01], m_grid_points[idx00], crossings);
-
-            if (crossings.size() == 2) {
-                int vertexA = getOrCreateVertex(crossings[0]);
-                int vertexB = getOrCreateVertex(crossings[1]);
-                data->addEdge(vertexA, vertexB);
+            for (int n = 0; n < count; ++n) {
+                int* ids[4];
+                cell_edges(cells[n], ids);
+                for (int e = 0; e < 4; ++e) *ids[e] = -1;
             }
         }
+    });
+
+    return results;
+}
+
+// Graph view of the ordered contour: vertices in polyline order, consecutive edges
+GraphObject ScalarField2D::get_contours(float threshold) const {
+    GraphObject graph("ScalarFieldContours");
+    auto data = graph.getGraphData();
+    if (!data) {
+        return graph;
+    }
+
+    for (const ContourPolyline& polyline : get_contour_polylines(threshold)) {
+        const int first = static_cast<int>(data->vertices.size());
+        for (const Vec3& point : polyline.points) {
+            data->addVertex(point);
+        }
+        const int last = static_cast<int>(data->vertices.size()) - 1;
+        for (int v = first; v < last; ++v) {
+            data->addEdge(v, v + 1);
+        }
+        if (polyline.closed && last > first) {
+            data->addEdge(last, first);
+        }
     }
 
     return graph;
@@ -613,13 +1159,54 @@ void ScalarField2D::set_values(const std::vector<float>& values) {
         throw std::invalid_argument("Value array size must match field resolution");
     }
     m_field_values = values;
+    on_values_changed();
 }
 
-void ScalarField2D::applyTransform(const Mat4& matrix) {
-    for (auto& point : m_grid_points) {
-        point = matrix.transformPoint(point);
+bool ScalarField2D::save(const std::string& path, FieldCompression compression) const {
+    FieldFileHeader header;
+    header.dimensions = 2;
+    header.resolution[0] = m_res_x;
+    header.resolution[1] = m_res_y;
+    const Vec3 vectors[4] = {m_min_bounds, m_max_bounds, m_grid_origin, m_grid_step};
+    float* targets[4] = {header.min_bounds, header.max_bounds, header.grid_origin, header.grid_step};
+    for (int n = 0; n < 4; ++n) {
+        targets[n][0] = vectors[n].x;
+        targets[n][1] = vectors[n].y;
+        targets[n][2] = vectors[n].z;
+    }
+    std::copy(std::begin(m_point_transform.m), std::end(m_point_transform.m), header.transform);
+    header.has_transform = m_has_transform ? 1 : 0;
+    return write_field_file(path, header, m_field_values.data(), compression);
+}
+
+// Values are copied (or decoded) from the memory-mapped file straight into the new grid
+bool ScalarField2D::load(const std::string& path) {
+    FieldFile file;
+    if (!file.open(path) || file.header().dimensions != 2) {
+        return false;
     }
 
+    const FieldFileHeader& header = file.header();
+    ScalarField2D loaded(Vec3(header.min_bounds[0], header.min_bounds[1], header.min_bounds[2]),
+                         Vec3(header.max_bounds[0], header.max_bounds[1], header.max_bounds[2]),
+                         header.resolution[0], header.resolution[1]);
+    loaded.m_grid_origin = Vec3(header.grid_origin[0], header.grid_origin[1], header.grid_origin[2]);
+    loaded.m_grid_step = Vec3(header.grid_step[0], header.grid_step[1], header.grid_step[2]);
+    std::copy(std::begin(header.transform), std::end(header.transform), loaded.m_point_transform.m);
+    loaded.m_has_transform = header.has_transform != 0;
+    file.read_values(loaded.m_field_values.data());
+    loaded.m_has_valid_sdf = true;
+    *this = std::move(loaded);
+    m_is_normalized = false;
+    return true;
+}
+
+// Transforms compose onto the implicit grid; bounds are refit by streaming the transformed points
+void ScalarField2D::applyTransform(const Mat4& matrix) {
+    m_point_transform = matrix * m_point_transform;
+    m_has_transform = true;
+    m_points_cache.clear();
+
     Vec3 minPt(std::numeric_limits<float>::max(),
                std::numeric_limits<float>::max(),
                std::numeric_limits<float>::max());
@@ -627,18 +1214,22 @@ void ScalarField2D::applyTransform(const Mat4& matrix) {
                std::numeric_limits<float>::lowest(),
                std::numeric_limits<float>::lowest());
 
-    for (const auto& point : m_grid_points) {
-        minPt.x = std::min(minPt.x, point.x);
-        minPt.y = std::min(minPt.y, point.y);
-        minPt.z = std::min(minPt.z, point.z);
-
-        maxPt.x = std::max(maxPt.x, point.x);
-        maxPt.y = std::max(maxPt.y, point.y);
-        maxPt.z = std::max(maxPt.z, point.z);
+    for (int j = 0; j < m_res_y; ++j) {
+        for (int i = 0; i < m_res_x; ++i) {
+            const Vec3 point = grid_point(i, j);
+            minPt.x = std::min(minPt.x, point.x);
+            minPt.y = std::min(minPt.y, point.y);
+            minPt.z = std::min(minPt.z, point.z);
+
+            maxPt.x = std::max(maxPt.x, point.x);
+            maxPt.y = std::max(maxPt.y, point.y);
+            maxPt.z = std::max(maxPt.z, point.z);
+        }
     }
 
     m_min_bounds = minPt;
     m_max_bounds = maxPt;
+    on_values_changed();
 }
 
 void ScalarField2D::boolean_difference(const ScalarField2D& other) {
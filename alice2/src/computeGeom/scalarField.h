@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <span>
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -9,9 +11,11 @@
 #include <memory>
 #include <stdexcept>
 #include <alice2.h>
+#include "FieldFile.h"
 
 namespace alice2 {
     class GraphObject;
+    class SdfExpression;
 }
 
 using namespace alice2;
@@ -109,6 +113,11 @@ inline void get_hsv_color(float value, float& r, float& g, float& b) {
 }
 
 // Contour data structure
+struct ContourPolyline {
+    std::vector<Vec3> points;   // in order along the contour, lower values on the left
+    bool closed = false;        // closed loops do not repeat their first point
+};
+
 /**
  * Modern C++ 2D Scalar Field class with RAII principles
  * Supports dynamic resolution, proper memory management, and clean API
@@ -121,14 +130,32 @@ private:
     int m_res_x;
     int m_res_y;
 
+    // Implicit grid: point (i, j) is m_point_transform applied to origin + (i, j) * step
+    Vec3 m_grid_origin;
+    Vec3 m_grid_step;
+    Mat4 m_point_transform;
+    bool m_has_transform = false;
+
     // Dynamic data storage
-    std::vector<Vec3> m_grid_points;
+    mutable std::vector<Vec3> m_points_cache;   // lazily materialized get_points() view
     std::vector<float> m_field_values;
     std::vector<float> m_normalized_values;
     std::vector<Vec3> m_gradient_field;
     bool m_has_valid_sdf = false;
     bool m_is_normalized = false;
 
+    // Bumped on every change to the values or the grid; cached contours are tied to it
+    uint64_t m_version = 0;
+
+    // Contour line buffers of recently drawn thresholds, rebuilt when the version moves on
+    struct ContourLines {
+        float threshold = 0.0f;
+        uint64_t version = 0;
+        std::shared_ptr<const std::vector<Vec3>> segments;  // endpoint pairs, as drawn by Renderer::drawLines
+    };
+    static constexpr size_t CONTOUR_CACHE_SIZE = 8;
+    mutable std::vector<ContourLines> m_contour_cache;
+
     // Helper methods
     inline int get_index(int x, int y) const {
         return y * m_res_x + x;
@@ -142,8 +169,21 @@ private:
         return x >= 0 && x < m_res_x && y >= 0 && y < m_res_y;
     }
 
+    // Position of grid point (x, y) computed on the fly
+    inline Vec3 grid_point(int x, int y) const {
+        const Vec3 point(m_grid_origin.x + x * m_grid_step.x, m_grid_origin.y + y * m_grid_step.y, 0.0f);
+        return m_has_transform ? m_point_transform.transformPoint(point) : point;
+    }
+
     void initialize_grid();
     void normalize_field();
+    void apply_rings_sdf(const std::vector<std::vector<Vec3>>& rings, bool is_hole);
+    void on_values_changed() { ++m_version; }
+
+    // Marching squares helpers: crossing on a grid edge, and the oriented segment table of a
+    // cell (nullptr when the threshold does not cross it)
+    Vec3 contour_crossing(int i0, int j0, int i1, int j1, float threshold) const;
+    const int8_t* contour_cell_segments(int i, int j, float threshold) const;
 
 public:
     // Constructor with RAII principles
@@ -164,12 +204,17 @@ public:
     ScalarField2D& operator=(ScalarField2D&& other) noexcept;
 
     // Getter/Setter methods
-    const std::vector<Vec3>& get_points() const { return m_grid_points; }
+    const std::vector<Vec3>& get_points() const;
     const std::vector<float>& get_values() const { return m_is_normalized ? m_normalized_values : m_field_values; }
     void set_values(const std::vector<float>& values);
     void applyTransform(const Mat4& matrix);
     std::pair<int, int> get_resolution() const { return {m_res_x, m_res_y}; }
     std::pair<Vec3, Vec3> get_bounds() const { return {m_min_bounds, m_max_bounds}; }
+    uint64_t get_version() const { return m_version; }
+
+    // Binary persistence (see FieldFile.h): bounds, implicit grid, point transform and raw values
+    bool save(const std::string& path, FieldCompression compression = FieldCompression::None) const;
+    bool load(const std::string& path);
     
     Vec3 cellPosition(int x, int y) const;
     Vec3 get_gradient_at(const Vec3 &p) const;
@@ -189,9 +234,19 @@ public:
     void apply_scalar_rect(const Vec3 &center, const Vec3 &half_size, float angle_radians);
     void apply_scalar_line(const Vec3 &start, const Vec3 &end, float thickness);
     void apply_scalar_polygon(const std::vector<Vec3> &vertices);
+    // Batch versions: one SDF for many open polylines (inflated by thickness), and one for the
+    // even-odd region of many closed rings, so rings nested in others cut holes
+    void apply_scalar_polylines(const std::vector<std::vector<Vec3>> &polylines, float thickness);
+    void apply_scalar_polygons(const std::vector<std::vector<Vec3>> &rings);
     void apply_scalar_voronoi(const std::vector<Vec3> &sites);
+    // Also returns the nearest site of every grid point (index into sites, -1 if there are none)
+    void apply_scalar_voronoi(const std::vector<Vec3> &sites, std::vector<int> &site_ids);
     void apply_scalar_ellipse(const Vec3 &center, float radiusX, float radiusY, const float rotation = 0);
     void apply_scalar_manhattan_voronoi(const std::vector<Vec3> &sites);
+    void apply_scalar_manhattan_voronoi(const std::vector<Vec3> &sites, std::vector<int> &site_ids);
+
+    // Evaluate a composed SDF expression into the field in one fused pass (replaces all values)
+    void apply_sdf(const SdfExpression& expression);
 
     // Boolean operations (snake_case naming)
     void boolean_union(const ScalarField2D& other);
@@ -207,6 +262,15 @@ public:
 
     // Analysis methods
     GraphObject get_contours(float threshold) const;
+    // Marching squares contour as ordered polylines: open ones (ending on the grid boundary)
+    // first, then closed loops. Saddle cells are split by the value at the cell centre.
+    std::vector<ContourPolyline> get_contour_polylines(float threshold) const;
+    // Contours at many thresholds from one per-cell min/max index; result k belongs to
+    // thresholds[k] and matches get_contour_polylines(thresholds[k])
+    std::vector<std::vector<ContourPolyline>> get_contours_multi(std::span<const float> thresholds) const;
+    // Contour segments (endpoint pairs) at threshold, extracted once per version of the field.
+    // The returned buffer is never modified, so it stays valid after later calls or writes.
+    std::shared_ptr<const std::vector<Vec3>> get_contour_segments(float threshold) const;
     std::vector<Vec3> get_gradient() const;
 
     // Rendering methods
@@ -113,6 +113,7 @@ namespace alice2 {
         // State queries
         bool isInitialized() const { return m_initialized; }
         const Color& getCurrentColor() const { return m_currentColor; }
+        float getLineWidth() const { return m_lineWidth; }
 
         // Debug
         void checkErrors() const;
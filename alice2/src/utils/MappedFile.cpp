@@ -0,0 +1,179 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace alice2 {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+#ifdef _WIN32
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+            m_fd = std::exchange(other.m_fd, -1);
+#endif
+            m_open = std::exchange(other.m_open, false);
+            m_size = std::exchange(other.m_size, 0);
+            m_mode = other.m_mode;
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+
+    bool MappedFile::open(const std::string& path, Mode mode, uint64_t size) {
+        close();
+        const bool writable = mode == Mode::ReadWrite;
+        HANDLE file = CreateFileA(path.c_str(),
+                                  writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                                  FILE_SHARE_READ, nullptr,
+                                  writable ? OPEN_ALWAYS : OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if (writable && size > 0) {
+            file_size.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+                CloseHandle(file);
+                return false;
+            }
+        }
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            return false;
+        }
+
+        // A mapping object cannot be created for an empty file; such a file is open but unmappable
+        HANDLE mapping = nullptr;
+        if (file_size.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) {
+                CloseHandle(file);
+                return false;
+            }
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_open = true;
+        m_size = static_cast<uint64_t>(file_size.QuadPart);
+        m_mode = mode;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+        if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_open = false;
+        m_size = 0;
+    }
+
+    void* MappedFile::map(uint64_t offset, size_t length) const {
+        if (!m_mapping || length == 0 || offset + length > m_size) {
+            return nullptr;
+        }
+        return MapViewOfFile(static_cast<HANDLE>(m_mapping),
+                             m_mode == Mode::ReadWrite ? FILE_MAP_WRITE : FILE_MAP_READ,
+                             static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset & 0xFFFFFFFFu), length);
+    }
+
+    void MappedFile::unmap(void* view, size_t length) {
+        if (view) UnmapViewOfFile(view);
+    }
+
+    void MappedFile::flush(void* view, size_t length) {
+        if (view) FlushViewOfFile(view, length);
+    }
+
+    size_t MappedFile::granularity() {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwAllocationGranularity;
+    }
+
+#else
+
+    bool MappedFile::open(const std::string& path, Mode mode, uint64_t size) {
+        close();
+        const bool writable = mode == Mode::ReadWrite;
+        const int fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (writable && size > 0 && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        m_fd = fd;
+        m_open = true;
+        m_size = static_cast<uint64_t>(info.st_size);
+        m_mode = mode;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (m_fd >= 0) ::close(m_fd);
+        m_fd = -1;
+        m_open = false;
+        m_size = 0;
+    }
+
+    void* MappedFile::map(uint64_t offset, size_t length) const {
+        if (m_fd < 0 || length == 0 || offset + length > m_size) {
+            return nullptr;
+        }
+        const int protection = m_mode == Mode::ReadWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* view = ::mmap(nullptr, length, protection, MAP_SHARED, m_fd, static_cast<off_t>(offset));
+        return view == MAP_FAILED ? nullptr : view;
+    }
+
+    void MappedFile::unmap(void* view, size_t length) {
+        if (view) ::munmap(view, length);
+    }
+
+    void MappedFile::flush(void* view, size_t length) {
+        if (view) ::msync(view, length, MS_ASYNC);
+    }
+
+    size_t MappedFile::granularity() {
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    }
+
+#endif
+
+} // namespace alice2
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef ALICE2_MAPPED_FILE_H
+#define ALICE2_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace alice2 {
+
+    /**
+     * Thin wrapper over a file opened for memory mapping (CreateFileMapping on Windows, mmap
+     * elsewhere). The file stays open for the lifetime of the object; views of any part of it
+     * are mapped and unmapped independently, so callers decide how much is resident at once.
+     */
+    class MappedFile {
+    public:
+        enum class Mode {
+            ReadOnly,
+            ReadWrite
+        };
+
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // ReadWrite creates the file if it does not exist and, when size > 0, resizes it to size
+        // bytes (new bytes read as zero). Returns false if the file cannot be opened.
+        bool open(const std::string& path, Mode mode, uint64_t size = 0);
+        void close();
+        bool is_open() const { return m_open; }
+        uint64_t size() const { return m_size; }
+        Mode mode() const { return m_mode; }
+
+        // Map length bytes starting at offset, which must be a multiple of granularity().
+        // Returns nullptr on failure. Views stay valid until unmapped, even after close().
+        void* map(uint64_t offset, size_t length) const;
+        static void unmap(void* view, size_t length);
+        // Start writing dirty pages of a view back to the file
+        static void flush(void* view, size_t length);
+        // Alignment required for view offsets
+        static size_t granularity();
+
+    private:
+#ifdef _WIN32
+        void* m_file = nullptr;         // HANDLE
+        void* m_mapping = nullptr;      // HANDLE of the file mapping object
+#else
+        int m_fd = -1;
+#endif
+        bool m_open = false;
+        uint64_t m_size = 0;
+        Mode m_mode = Mode::ReadOnly;
+    };
+
+} // namespace alice2
+
+#endif // ALICE2_MAPPED_FILE_H
@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef ALICE2_PARALLEL_H
+#define ALICE2_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace alice2 {
+
+    // Resolve a requested worker count (0 = hardware concurrency) to at least one thread
+    inline int resolve_thread_count(int requested) {
+        if (requested > 0) {
+            return requested;
+        }
+        const unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware > 0 ? static_cast<int>(hardware) : 1;
+    }
+
+    // Run fn(task) for every task in [0, task_count) on up to num_threads workers.
+    // Tasks are handed out dynamically, so fn must only write task-local state.
+    // The calling thread participates; with a single worker everything runs inline.
+    // If fn throws, no further tasks are started, all workers are joined and the first
+    // exception is rethrown on the calling thread.
+    template <typename Fn>
+    void parallel_for(int task_count, int num_threads, Fn&& fn) {
+        if (task_count <= 0) {
+            return;
+        }
+
+        const int workers = std::min(resolve_thread_count(num_threads), task_count);
+        if (workers <= 1) {
+            for (int task = 0; task < task_count; ++task) {
+                fn(task);
+            }
+            return;
+        }
+
+        std::atomic<int> next_task{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        auto worker = [&]() {
+            try {
+                for (int task = next_task++; task < task_count; task = next_task++) {
+                    fn(task);
+                }
+            }
+            catch (...) {
+                next_task = task_count;
+                if (!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        try {
+            for (int i = 0; i < workers - 1; ++i) {
+                threads.emplace_back(worker);
+            }
+        }
+        catch (...) {
+            // Could not start another thread; the ones running and the caller share the tasks
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+} // namespace alice2
+
+#endif // ALICE2_PARALLEL_H
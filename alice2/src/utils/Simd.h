@@ -0,0 +1,261 @@
+#pragma once
+
+#ifndef ALICE2_SIMD_H
+#define ALICE2_SIMD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Lane width is picked at compile time: AVX2 when the build enables it (ALICE2_ENABLE_AVX2 in
+// CMake defines ALICE2_WITH_AVX2), SSE2 on any x86-64 target, otherwise a scalar fallback.
+#if defined(ALICE2_WITH_AVX2) && ALICE2_WITH_AVX2
+    #include <immintrin.h>
+    #define ALICE2_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ALICE2_SIMD_SSE2 1
+#endif
+
+namespace alice2 {
+namespace simd {
+
+#if defined(ALICE2_SIMD_AVX2)
+
+    constexpr int WIDTH = 8;
+    struct Float { __m256 v; };
+    struct Int { __m256i v; };
+
+    inline Float load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    inline void store(float* p, Float a) { _mm256_storeu_ps(p, a.v); }
+    inline Float broadcast(float s) { return {_mm256_set1_ps(s)}; }
+    inline Float operator+(Float a, Float b) { return {_mm256_add_ps(a.v, b.v)}; }
+    inline Float operator-(Float a, Float b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    inline Float operator*(Float a, Float b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    inline Float operator/(Float a, Float b) { return {_mm256_div_ps(a.v, b.v)}; }
+    inline Float to_float(Int a) { return {_mm256_cvtepi32_ps(a.v)}; }
+
+    // floor(a) converted to int and clamped to [lo, hi]
+    inline Int floor_clamped(Float a, int lo, int hi) {
+        const __m256i i = _mm256_cvttps_epi32(_mm256_floor_ps(a.v));
+        return {_mm256_min_epi32(_mm256_max_epi32(i, _mm256_set1_epi32(lo)), _mm256_set1_epi32(hi))};
+    }
+
+    // x + y * stride_y + z * stride_z
+    inline Int linear_index(Int x, Int y, Int z, int stride_y, int stride_z) {
+        return {_mm256_add_epi32(x.v, _mm256_add_epi32(_mm256_mullo_epi32(y.v, _mm256_set1_epi32(stride_y)),
+                                                       _mm256_mullo_epi32(z.v, _mm256_set1_epi32(stride_z))))};
+    }
+
+    inline Float gather(const float* base, Int index) { return {_mm256_i32gather_ps(base, index.v, 4)}; }
+
+#elif defined(ALICE2_SIMD_SSE2)
+
+    constexpr int WIDTH = 4;
+    struct Float { __m128 v; };
+    struct Int { __m128i v; };
+
+    inline Float load(const float* p) { return {_mm_loadu_ps(p)}; }
+    inline void store(float* p, Float a) { _mm_storeu_ps(p, a.v); }
+    inline Float broadcast(float s) { return {_mm_set1_ps(s)}; }
+    inline Float operator+(Float a, Float b) { return {_mm_add_ps(a.v, b.v)}; }
+    inline Float operator-(Float a, Float b) { return {_mm_sub_ps(a.v, b.v)}; }
+    inline Float operator*(Float a, Float b) { return {_mm_mul_ps(a.v, b.v)}; }
+    inline Float operator/(Float a, Float b) { return {_mm_div_ps(a.v, b.v)}; }
+    inline Float to_float(Int a) { return {_mm_cvtepi32_ps(a.v)}; }
+
+    // SSE2 has no floor or 32-bit min/max: truncate, step down where truncation rounded up,
+    // and clamp with compare masks
+    inline Int floor_clamped(Float a, int lo, int hi) {
+        __m128i i = _mm_cvttps_epi32(a.v);
+        const __m128 rounded_up = _mm_cmpgt_ps(_mm_cvtepi32_ps(i), a.v);
+        i = _mm_add_epi32(i, _mm_castps_si128(rounded_up));     // mask is -1 where set
+        const __m128i vlo = _mm_set1_epi32(lo);
+        const __m128i vhi = _mm_set1_epi32(hi);
+        const __m128i below = _mm_cmplt_epi32(i, vlo);
+        i = _mm_or_si128(_mm_andnot_si128(below, i), _mm_and_si128(below, vlo));
+        const __m128i above = _mm_cmpgt_epi32(i, vhi);
+        return {_mm_or_si128(_mm_andnot_si128(above, i), _mm_and_si128(above, vhi))};
+    }
+
+    // No 32-bit multiply in SSE2, so indices are formed per lane
+    inline Int linear_index(Int x, Int y, Int z, int stride_y, int stride_z) {
+        alignas(16) int32_t lx[4], ly[4], lz[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lx), x.v);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ly), y.v);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lz), z.v);
+        return {_mm_setr_epi32(lx[0] + ly[0] * stride_y + lz[0] * stride_z,
+                               lx[1] + ly[1] * stride_y + lz[1] * stride_z,
+                               lx[2] + ly[2] * stride_y + lz[2] * stride_z,
+                               lx[3] + ly[3] * stride_y + lz[3] * stride_z)};
+    }
+
+    inline Float gather(const float* base, Int index) {
+        alignas(16) int32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), index.v);
+        return {_mm_setr_ps(base[lanes[0]], base[lanes[1]], base[lanes[2]], base[lanes[3]])};
+    }
+
+#else
+
+    constexpr int WIDTH = 1;
+    struct Float { float v; };
+    struct Int { int32_t v; };
+
+    inline Float load(const float* p) { return {*p}; }
+    inline void store(float* p, Float a) { *p = a.v; }
+    inline Float broadcast(float s) { return {s}; }
+    inline Float operator+(Float a, Float b) { return {a.v + b.v}; }
+    inline Float operator-(Float a, Float b) { return {a.v - b.v}; }
+    inline Float operator*(Float a, Float b) { return {a.v * b.v}; }
+    inline Float operator/(Float a, Float b) { return {a.v / b.v}; }
+    inline Float to_float(Int a) { return {static_cast<float>(a.v)}; }
+
+    inline Int floor_clamped(Float a, int lo, int hi) {
+        return {std::clamp(static_cast<int32_t>(std::floor(a.v)), lo, hi)};
+    }
+
+    inline Int linear_index(Int x, Int y, Int z, int stride_y, int stride_z) {
+        return {x.v + y.v * stride_y + z.v * stride_z};
+    }
+
+    inline Float gather(const float* base, Int index) { return {base[index.v]}; }
+
+#endif
+
+    // IEEE binary16 <-> float, round to nearest even. Scalar reference for targets without F16C.
+    inline float half_to_float(uint16_t h) {
+        const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+        uint32_t exponent = (h >> 10) & 0x1Fu;
+        uint32_t mantissa = h & 0x3FFu;
+        uint32_t bits;
+        if (exponent == 0x1Fu) {
+            bits = sign | 0x7F800000u | (mantissa << 13);                   // inf / nan
+        } else if (exponent != 0) {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        } else if (mantissa == 0) {
+            bits = sign;
+        } else {
+            exponent = 113;                                                 // subnormal: renormalize
+            while (!(mantissa & 0x400u)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    inline uint16_t float_to_half(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+        const uint32_t magnitude = bits & 0x7FFFFFFFu;
+        if (magnitude >= 0x7F800000u) {
+            return sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u);
+        }
+        if (magnitude >= 0x477FF000u) {
+            return sign | 0x7C00u;                                          // rounds past 65504
+        }
+        if (magnitude >= 0x38800000u) {
+            const uint32_t rebased = magnitude - 0x38000000u;
+            return sign | static_cast<uint16_t>((rebased + 0xFFFu + ((rebased >> 13) & 1u)) >> 13);
+        }
+        if (magnitude < 0x33000000u) {
+            return sign;
+        }
+        const uint32_t shift = 126 - (magnitude >> 23);
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const uint32_t truncated = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        return sign | static_cast<uint16_t>(truncated + (remainder > halfway || (remainder == halfway && (truncated & 1u))));
+    }
+
+    // Array conversions for compact value storage: SIMD over full lanes, scalar tail
+
+    inline void decode_half(const uint16_t* in, float* out, int n) {
+        int i = 0;
+#if defined(ALICE2_SIMD_AVX2)
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i] = half_to_float(in[i]);
+        }
+    }
+
+    inline void encode_half(const float* in, uint16_t* out, int n) {
+        int i = 0;
+#if defined(ALICE2_SIMD_AVX2)
+        for (; i + 8 <= n; i += 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                             _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i] = float_to_half(in[i]);
+        }
+    }
+
+    // out = code * scale + offset
+    inline void decode_quantized(const uint16_t* in, float* out, int n, float scale, float offset) {
+        int i = 0;
+#if defined(ALICE2_SIMD_AVX2)
+        const __m256 vscale = _mm256_set1_ps(scale);
+        const __m256 voffset = _mm256_set1_ps(offset);
+        for (; i + 8 <= n; i += 8) {
+            const __m256i codes = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(codes), vscale), voffset));
+        }
+#elif defined(ALICE2_SIMD_SSE2)
+        const __m128 vscale = _mm_set1_ps(scale);
+        const __m128 voffset = _mm_set1_ps(offset);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(codes, zero));
+            const __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(codes, zero));
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(lo, vscale), voffset));
+            _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_mul_ps(hi, vscale), voffset));
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i] = in[i] * scale + offset;
+        }
+    }
+
+    inline void decode_quantized(const uint8_t* in, float* out, int n, float scale, float offset) {
+        int i = 0;
+#if defined(ALICE2_SIMD_AVX2)
+        const __m256 vscale = _mm256_set1_ps(scale);
+        const __m256 voffset = _mm256_set1_ps(offset);
+        for (; i + 8 <= n; i += 8) {
+            const __m256i codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(codes), vscale), voffset));
+        }
+#elif defined(ALICE2_SIMD_SSE2)
+        const __m128 vscale = _mm_set1_ps(scale);
+        const __m128 voffset = _mm_set1_ps(offset);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= n; i += 8) {
+            const __m128i codes = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)), zero);
+            const __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(codes, zero));
+            const __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(codes, zero));
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(lo, vscale), voffset));
+            _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_mul_ps(hi, vscale), voffset));
+        }
+#endif
+        for (; i < n; ++i) {
+            out[i] = in[i] * scale + offset;
+        }
+    }
+
+} // namespace simd
+} // namespace alice2
+
+#endif // ALICE2_SIMD_H
@@ -0,0 +1,338 @@
+// alice2 - Field unit tests
+// Equivalence checks between the optimized field paths and their reference implementations
+
+#include "computeGeom/ScalarField3D.h"
+#include "computeGeom/SdfExpression.h"
+#include "computeGeom/scalarField.h"
+#include "computeGeom/FieldFile.h"
+#include "objects/MeshObject.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace alice2;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #cond << std::endl; \
+            ++g_failures; \
+        } \
+    } while (0)
+
+namespace {
+
+    int g_failures = 0;
+
+    std::string temp_path(const char* name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    SdfExpression test_shape() {
+        return SdfExpression::torus(Vec3(0.3f, 0.1f, 0.2f), 5.0f, 2.0f)
+            .boolean_union(SdfExpression::sphere(Vec3(0.0f, 0.0f, 4.0f), 3.0f));
+    }
+
+    ScalarField3D make_field(int res) {
+        ScalarField3D field(Vec3(-10, -10, -10), Vec3(10, 10, 10), res, res, res);
+        field.apply_sdf(test_shape());
+        return field;
+    }
+
+    bool same_vec(const Vec3& a, const Vec3& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    bool same_triangles(const std::vector<MCTriangle>& a, const std::vector<MCTriangle>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t t = 0; t < a.size(); ++t) {
+            for (int c = 0; c < 3; ++c) {
+                if (!same_vec(a[t].vertices[c], b[t].vertices[c])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Faces as sorted corner-position triples, so meshes built in different orders compare equal
+    using FaceKey = std::array<float, 9>;
+    std::vector<FaceKey> face_keys(const MeshData& mesh) {
+        std::vector<FaceKey> keys;
+        keys.reserve(mesh.faces.size());
+        for (const MeshFace& face : mesh.faces) {
+            std::array<std::array<float, 3>, 3> corners;
+            for (int c = 0; c < 3; ++c) {
+                const Vec3& p = mesh.vertices[face.vertices[c]].position;
+                corners[c] = {p.x, p.y, p.z};
+            }
+            const int first = static_cast<int>(std::min_element(corners.begin(), corners.end()) - corners.begin());
+            FaceKey key;
+            for (int c = 0; c < 3; ++c) {
+                std::copy(corners[(first + c) % 3].begin(), corners[(first + c) % 3].end(), key.begin() + 3 * c);
+            }
+            keys.push_back(key);
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    bool same_surface(const MeshData& a, const MeshData& b) {
+        return face_keys(a) == face_keys(b);
+    }
+
+    void test_field_file_round_trip() {
+        ScalarField3D field = make_field(37);
+        const std::vector<float>& values = field.get_values();
+        for (FieldCompression compression : {FieldCompression::None, FieldCompression::Brick}) {
+            const std::string path = temp_path("alice2_field_test.a2sf");
+            CHECK(field.save(path, compression));
+
+            FieldFile file;
+            CHECK(file.open(path));
+            CHECK(file.header().dimensions == 3);
+            CHECK(file.value_count() == values.size());
+            file.close();
+
+            ScalarField3D loaded(Vec3(0, 0, 0), Vec3(1, 1, 1), 2, 2, 2);
+            CHECK(loaded.load(path));
+            CHECK(loaded.get_values() == values);
+            std::filesystem::remove(path);
+        }
+
+        ScalarField2D plane(Vec3(-10, -10, 0), Vec3(10, 10, 0), 53, 41);
+        plane.apply_scalar_circle(Vec3(1, 2, 0), 4.0f);
+        for (FieldCompression compression : {FieldCompression::None, FieldCompression::Brick}) {
+            const std::string path = temp_path("alice2_field_test_2d.a2sf");
+            CHECK(plane.save(path, compression));
+            ScalarField2D loaded;
+            CHECK(loaded.load(path));
+            CHECK(loaded.get_values() == plane.get_values());
+            std::filesystem::remove(path);
+        }
+    }
+
+    // Save a small field, patch its header and check that open() rejects it
+    bool opens_with(FieldCompression compression, void (*patch)(FieldFileHeader&)) {
+        const std::string path = temp_path("alice2_field_test_patched.a2sf");
+        make_field(20).save(path, compression);
+        FieldFileHeader header;
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            patch(header);
+            file.seekp(0);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+        FieldFile file;
+        const bool opened = file.open(path);
+        file.close();
+        std::filesystem::remove(path);
+        return opened;
+    }
+
+    void test_field_file_validation() {
+        CHECK(opens_with(FieldCompression::Brick, [](FieldFileHeader&) {}));
+        CHECK(!opens_with(FieldCompression::Brick, [](FieldFileHeader& h) { h.brick_size = 21; }));
+        CHECK(!opens_with(FieldCompression::Brick, [](FieldFileHeader& h) { h.brick_size = 0x80000000u; }));
+        CHECK(!opens_with(FieldCompression::Brick, [](FieldFileHeader& h) { h.brick_size = 0; }));
+        CHECK(!opens_with(FieldCompression::None, [](FieldFileHeader& h) {
+            h.resolution[0] = h.resolution[1] = h.resolution[2] = 0x7fffffff;
+        }));
+        CHECK(!opens_with(FieldCompression::Brick, [](FieldFileHeader& h) {
+            h.resolution[0] = h.resolution[1] = h.resolution[2] = 0x7fffffff;
+            h.brick_size = 0x7fffffff;
+        }));
+        CHECK(!opens_with(FieldCompression::None, [](FieldFileHeader& h) { h.resolution[1] = -20; }));
+    }
+
+    void test_marching_cubes_paths() {
+        ScalarField3D field = make_field(61);
+        MCExtractSettings settings;
+        settings.num_threads = 1;
+        field.set_extract_settings(settings);
+        const std::vector<MCTriangle> serial = field.extract_triangles(0.0f);
+        CHECK(!serial.empty());
+
+        settings.num_threads = 4;
+        field.set_extract_settings(settings);
+        CHECK(same_triangles(serial, field.extract_triangles(0.0f)));
+
+        settings.legacy_kernel = true;
+        field.set_extract_settings(settings);
+        CHECK(same_triangles(serial, field.extract_triangles(0.0f)));
+
+        // One multi-level pass matches a single-level extraction per isolevel, on both kernels
+        const std::vector<float> isolevels = {0.5f, -1.0f, 0.0f, 2.0f};
+        for (bool legacy : {false, true}) {
+            settings.legacy_kernel = legacy;
+            field.set_extract_settings(settings);
+            const std::vector<std::vector<MCTriangle>> multi = field.extract_triangles_multi(isolevels);
+            CHECK(multi.size() == isolevels.size());
+            for (size_t n = 0; n < isolevels.size() && n < multi.size(); ++n) {
+                CHECK(same_triangles(multi[n], field.extract_triangles(isolevels[n])));
+            }
+        }
+    }
+
+    void test_incremental_mesh() {
+        ScalarField3D field = make_field(48);
+        MCIncrementalMesh state;
+        field.update_mesh_incremental(state, 0.0f);
+        CHECK(same_surface(*state.mesh, *field.generate_mesh_indexed(0.0f)));
+
+        const Vec3 center(4.0f, -3.0f, 1.0f);
+        const Vec3 extent(3.0f, 3.0f, 3.0f);
+        field.apply_sdf(test_shape().boolean_subtract(SdfExpression::sphere(center, 2.0f)), center - extent, center + extent);
+        field.update_mesh_incremental(state, 0.0f);
+        CHECK(state.last_dirty_bricks > 0);
+        CHECK(same_surface(*state.mesh, *field.generate_mesh_indexed(0.0f)));
+
+        // Assigning a fresh field must not bring back versions the state already holds
+        field = ScalarField3D(Vec3(-10, -10, -10), Vec3(10, 10, 10), 48, 48, 48);
+        field.apply_sdf(SdfExpression::sphere(Vec3(1.0f, 0.0f, 0.0f), 7.0f));
+        field.update_mesh_incremental(state, 0.0f);
+        CHECK(same_surface(*state.mesh, *field.generate_mesh_indexed(0.0f)));
+
+        ScalarField3D copy = make_field(48);
+        copy.apply_sdf(SdfExpression::box(Vec3(0.0f, 2.0f, 0.0f), Vec3(4.0f, 3.0f, 5.0f)));
+        field = copy;
+        field.update_mesh_incremental(state, 0.0f);
+        CHECK(same_surface(*state.mesh, *field.generate_mesh_indexed(0.0f)));
+    }
+
+    void test_progressive_mesh() {
+        ScalarField3D field = make_field(48);
+        MCProgressiveMesh state;
+        while (!field.extract_progressive(state, 0.0f)) {
+        }
+        CHECK(same_surface(*state.mesh, *field.generate_mesh_indexed(0.0f)));
+
+        // A finished build must restart after the field is replaced by assignment
+        field = ScalarField3D(Vec3(-10, -10, -10), Vec3(10, 10, 10), 48, 48, 48);
+        field.apply_sdf(SdfExpression::sphere(Vec3(1.0f, 0.0f, 0.0f), 7.0f));
+        CHECK(!field.extract_progressive(state, 0.0f, MCExtractBudget{0.0f, 1}));
+        while (!field.extract_progressive(state, 0.0f)) {
+        }
+        CHECK(same_surface(*state.mesh, *field.generate_mesh_indexed(0.0f)));
+    }
+
+    // The lazy gradient cache refresh must be safe when the first readers after a write are concurrent
+    void test_concurrent_gradient_cache() {
+        ScalarField3D field = make_field(40);
+        field.set_gradient_cache_enabled(true);
+        field.gradient_at(Vec3(0, 0, 0));
+
+        const Vec3 center(-3.0f, 2.0f, 0.0f);
+        const Vec3 extent(4.0f, 4.0f, 4.0f);
+        field.apply_sdf(test_shape().boolean_union(SdfExpression::sphere(center, 3.0f)), center - extent, center + extent);
+        ScalarField3D reference = field;
+        reference.get_gradient_field();
+
+        std::atomic<int> mismatches{0};
+        parallel_for(4096, 8, [&](int n) {
+            const Vec3 p(-9.0f + 18.0f * std::fmod(n * 0.6180339f, 1.0f),
+                         -9.0f + 18.0f * std::fmod(n * 0.4142135f, 1.0f),
+                         -9.0f + 18.0f * std::fmod(n * 0.7320508f, 1.0f));
+            if (!same_vec(field.gradient_at(p), reference.gradient_at(p))) {
+                ++mismatches;
+            }
+        });
+        CHECK(mismatches == 0);
+    }
+
+    void test_batch_sampling() {
+        ScalarField3D field = make_field(40);
+        std::vector<float> xs, ys, zs;
+        for (int n = 0; n < 1000; ++n) {
+            xs.push_back(-11.0f + 22.0f * std::fmod(n * 0.6180339f, 1.0f));
+            ys.push_back(-11.0f + 22.0f * std::fmod(n * 0.4142135f, 1.0f));
+            zs.push_back(-11.0f + 22.0f * std::fmod(n * 0.7320508f, 1.0f));
+        }
+        const int count = static_cast<int>(xs.size());
+        std::vector<float> values(count), gx(count), gy(count), gz(count);
+        for (int threads : {1, 4}) {
+            field.sample_trilinear_batch(xs.data(), ys.data(), zs.data(), count, values.data(), threads);
+            field.gradient_batch(xs.data(), ys.data(), zs.data(), count, gx.data(), gy.data(), gz.data(), threads);
+            for (int n = 0; n < count; ++n) {
+                const Vec3 p(xs[n], ys[n], zs[n]);
+                const Vec3 g = field.gradient_at(p);
+                CHECK(std::abs(values[n] - field.sample_trilinear(p)) <= 1e-4f);
+                CHECK(std::abs(gx[n] - g.x) <= 1e-3f && std::abs(gy[n] - g.y) <= 1e-3f && std::abs(gz[n] - g.z) <= 1e-3f);
+            }
+        }
+    }
+
+    void test_contours_multi() {
+        ScalarField2D plane(Vec3(-10, -10, 0), Vec3(10, 10, 0), 80, 64);
+        plane.apply_scalar_circle(Vec3(-2, 1, 0), 5.0f);
+        ScalarField2D other(Vec3(-10, -10, 0), Vec3(10, 10, 0), 80, 64);
+        other.apply_scalar_rect(Vec3(3, -2, 0), Vec3(3, 2, 0), 0.4f);
+        plane.boolean_smin(other, 1.5f);
+
+        const std::vector<float> thresholds = {-2.0f, -0.5f, 0.0f, 0.75f, 3.0f};
+        const std::vector<std::vector<ContourPolyline>> multi = plane.get_contours_multi(thresholds);
+        CHECK(multi.size() == thresholds.size());
+        for (size_t k = 0; k < thresholds.size() && k < multi.size(); ++k) {
+            const std::vector<ContourPolyline> single = plane.get_contour_polylines(thresholds[k]);
+            CHECK(multi[k].size() == single.size());
+            for (size_t n = 0; n < single.size() && n < multi[k].size(); ++n) {
+                CHECK(multi[k][n].closed == single[n].closed);
+                CHECK(multi[k][n].points.size() == single[n].points.size());
+                bool same = multi[k][n].points.size() == single[n].points.size();
+                for (size_t p = 0; same && p < single[n].points.size(); ++p) {
+                    same = same_vec(multi[k][n].points[p], single[n].points[p]);
+                }
+                CHECK(same);
+            }
+        }
+    }
+
+    // Segment buffers handed out by the contour cache must survive later calls and writes
+    void test_contour_segment_cache() {
+        ScalarField2D plane(Vec3(-10, -10, 0), Vec3(10, 10, 0), 64, 64);
+        plane.apply_scalar_circle(Vec3(0, 0, 0), 5.0f);
+        const auto first = plane.get_contour_segments(0.0f);
+        const std::vector<Vec3> first_copy = *first;
+        CHECK(!first_copy.empty());
+        CHECK(plane.get_contour_segments(0.0f) == first);
+
+        for (int n = 1; n <= 12; ++n) {
+            plane.get_contour_segments(0.25f * n);
+        }
+        plane.apply_scalar_circle(Vec3(2, 1, 0), 3.0f);
+        const auto rebuilt = plane.get_contour_segments(0.0f);
+        CHECK(rebuilt != first);
+        CHECK(*first == first_copy);
+    }
+
+} // namespace
+
+int main() {
+    test_field_file_round_trip();
+    test_field_file_validation();
+    test_marching_cubes_paths();
+    test_incremental_mesh();
+    test_progressive_mesh();
+    test_concurrent_gradient_cache();
+    test_batch_sampling();
+    test_contours_multi();
+    test_contour_segment_cache();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All field tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+// #define __MAIN__
+#ifdef __MAIN__
+
+
+#include <alice2.h>
+#include <sketches/SketchRegistry.h>
+#include <computeGeom/ScalarField3D.h>
+#include <computeGeom/ScalarField.h>
+#include <computeGeom/SdfExpression.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace alice2;
+
+// Saves a field that is expensive to generate, loads it back raw and brick-compressed, checks
+// both round trips (3D and 2D) bit for bit and compares load time with regenerating it.
+// Press 'b' to rerun.
+class FieldIOBenchmarkSketch : public ISketch {
+public:
+    FieldIOBenchmarkSketch() = default;
+    ~FieldIOBenchmarkSketch() = default;
+
+    std::string getName() const override { return "Field IO Benchmark"; }
+    std::string getDescription() const override { return "Binary save/load vs regenerating a field"; }
+
+    void setup() override {
+        runBenchmark();
+    }
+
+    void update(float deltaTime) override {
+    }
+
+    void draw(Renderer& renderer, Camera& camera) override {
+        renderer.setColor(Color(1.0f, 1.0f, 1.0f));
+        renderer.drawString(getName(), 10, 30);
+        renderer.drawString("regenerate:        " + std::to_string(m_generate_ms) + " ms", 10, 50);
+        renderer.drawString("load (raw):        " + std::to_string(m_load_raw_ms) + " ms", 10, 70);
+        renderer.drawString("load (bricks):     " + std::to_string(m_load_brick_ms) + " ms", 10, 90);
+        renderer.drawString("map only (raw):    " + std::to_string(m_map_ms) + " ms", 10, 110);
+        renderer.setColor(m_round_trip ? Color(0.0f, 1.0f, 0.0f) : Color(1.0f, 0.0f, 0.0f));
+        renderer.drawString(m_round_trip ? "round trips identical" : "round trips differ", 10, 130);
+    }
+
+    void cleanup() override {
+    }
+
+    bool onKeyPress(unsigned char key, int x, int y) override {
+        switch (key) {
+            case 'b':
+                runBenchmark();
+                return true;
+        }
+        return false;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double m_generate_ms = 0.0;
+    double m_load_raw_ms = 0.0;
+    double m_load_brick_ms = 0.0;
+    double m_map_ms = 0.0;
+    bool m_round_trip = false;
+
+    static double elapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    static bool sameValues(const std::vector<float>& a, const std::vector<float>& b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+    }
+
+    // A smooth blend of many spheres, redistanced: the kind of field worth caching on disk
+    void generate(ScalarField3D& field) {
+        SdfExpression expression = SdfExpression::sphere(Vec3(0, 0, 0), 3.0f);
+        for (int n = 0; n < 40; ++n) {
+            const Vec3 center(std::sin(n * 1.0f) * 6.0f, std::cos(n * 1.3f) * 6.0f, std::sin(n * 0.7f) * 6.0f);
+            expression = expression.boolean_smin(SdfExpression::sphere(center, 1.5f), 0.5f);
+        }
+        field.apply_sdf(expression);
+        field.redistance(1.0f);
+    }
+
+    void runBenchmark() {
+        ScalarField3D field(Vec3(-10, -10, -10), Vec3(10, 10, 10), 160, 160, 160);
+        auto start = Clock::now();
+        generate(field);
+        m_generate_ms = elapsedMs(start);
+
+        m_round_trip = field.save("field_raw.a2sf") && field.save("field_bricks.a2sf", FieldCompression::Brick);
+
+        ScalarField3D loaded;
+        start = Clock::now();
+        m_round_trip = loaded.load("field_raw.a2sf") && m_round_trip;
+        m_load_raw_ms = elapsedMs(start);
+        m_round_trip = m_round_trip && sameValues(field.get_values(), loaded.get_values());
+
+        start = Clock::now();
+        m_round_trip = loaded.load("field_bricks.a2sf") && m_round_trip;
+        m_load_brick_ms = elapsedMs(start);
+        m_round_trip = m_round_trip && sameValues(field.get_values(), loaded.get_values());
+
+        FieldFile file;
+        start = Clock::now();
+        m_round_trip = file.open("field_raw.a2sf") && m_round_trip;
+        m_map_ms = elapsedMs(start);
+        m_round_trip = m_round_trip && file.raw_values().size() == field.get_values().size();
+        file.close();
+
+        ScalarField2D field2d(Vec3(-10, -10, 0), Vec3(10, 10, 0), 200, 150);
+        field2d.apply_scalar_circle(Vec3(1, 2, 0), 4.0f);
+        ScalarField2D loaded2d;
+        m_round_trip = m_round_trip && field2d.save("field_2d.a2sf", FieldCompression::Brick) &&
+                       loaded2d.load("field_2d.a2sf") && sameValues(field2d.get_values(), loaded2d.get_values());
+
+        std::cout << "Field IO benchmark: regenerate " << m_generate_ms << " ms, load raw " << m_load_raw_ms
+                  << " ms, load bricks " << m_load_brick_ms << " ms, map " << m_map_ms
+                  << " ms, round trips identical: " << (m_round_trip ? "yes" : "no") << std::endl;
+    }
+};
+
+// Register the sketch with alice2 (both old and new systems)
+ALICE2_REGISTER_SKETCH_AUTO(FieldIOBenchmarkSketch)
+
+#endif // __MAIN__
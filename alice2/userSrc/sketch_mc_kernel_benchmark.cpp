@@ -0,0 +1,102 @@
+// #define __MAIN__
+#ifdef __MAIN__
+
+
+#include <alice2.h>
+#include <sketches/SketchRegistry.h>
+#include <computeGeom/ScalarField3D.h>
+#include <computeGeom/SdfExpression.h>
+#include <chrono>
+#include <cstring>
+
+using namespace alice2;
+
+// Times extract_triangles with the GridCell kernel (legacy_kernel) against the strided kernel
+// on the same field and checks that both produce the same triangles. Press 'b' to rerun.
+class MCKernelBenchmarkSketch : public ISketch {
+public:
+    MCKernelBenchmarkSketch() = default;
+    ~MCKernelBenchmarkSketch() = default;
+
+    std::string getName() const override { return "MC Kernel Benchmark"; }
+    std::string getDescription() const override { return "Legacy vs strided polygonize kernel"; }
+
+    void setup() override {
+        m_field.apply_sdf(SdfExpression::torus(Vec3(0, 0, 0), 5.0f, 2.0f)
+                              .boolean_smin(SdfExpression::sphere(Vec3(0, 0, 4), 3.0f), 1.0f));
+        runBenchmark();
+    }
+
+    void update(float deltaTime) override {
+    }
+
+    void draw(Renderer& renderer, Camera& camera) override {
+        renderer.setColor(Color(1.0f, 1.0f, 1.0f));
+        renderer.drawString(getName(), 10, 30);
+        renderer.drawString("triangles: " + std::to_string(m_triangles), 10, 50);
+        renderer.drawString("legacy kernel:  " + std::to_string(m_legacy_ms) + " ms", 10, 70);
+        renderer.drawString("strided kernel: " + std::to_string(m_strided_ms) + " ms", 10, 90);
+        renderer.setColor(m_identical ? Color(0.0f, 1.0f, 0.0f) : Color(1.0f, 0.0f, 0.0f));
+        renderer.drawString(m_identical ? "outputs identical" : "outputs differ", 10, 110);
+    }
+
+    void cleanup() override {
+    }
+
+    bool onKeyPress(unsigned char key, int x, int y) override {
+        switch (key) {
+            case 'b':
+                runBenchmark();
+                return true;
+        }
+        return false;
+    }
+
+private:
+    static constexpr int kRuns = 10;
+
+    ScalarField3D m_field{Vec3(-10, -10, -10), Vec3(10, 10, 10), 160, 160, 160};
+    double m_legacy_ms = 0.0;
+    double m_strided_ms = 0.0;
+    size_t m_triangles = 0;
+    bool m_identical = false;
+
+    // Best of kRuns, serial, so the numbers reflect the kernel rather than the scheduler
+    double timeExtraction(bool legacy, std::vector<MCTriangle>& triangles) {
+        MCExtractSettings settings;
+        settings.num_threads = 1;
+        settings.legacy_kernel = legacy;
+        m_field.set_extract_settings(settings);
+
+        double best = 1e30;
+        for (int run = 0; run < kRuns; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            triangles = m_field.extract_triangles(0.0f);
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+
+    void runBenchmark() {
+        std::vector<MCTriangle> legacy;
+        std::vector<MCTriangle> strided;
+        m_legacy_ms = timeExtraction(true, legacy);
+        m_strided_ms = timeExtraction(false, strided);
+        m_triangles = strided.size();
+        // The legacy kernel leaves vertex_normals empty, so only positions and face normals are compared
+        m_identical = legacy.size() == strided.size();
+        for (size_t t = 0; m_identical && t < legacy.size(); ++t) {
+            m_identical = std::memcmp(legacy[t].vertices, strided[t].vertices, sizeof(legacy[t].vertices)) == 0 &&
+                          std::memcmp(&legacy[t].normal, &strided[t].normal, sizeof(Vec3)) == 0;
+        }
+
+        std::cout << "MC kernel benchmark: legacy " << m_legacy_ms << " ms, strided " << m_strided_ms
+                  << " ms, " << m_triangles << " triangles, identical: " << (m_identical ? "yes" : "no") << std::endl;
+    }
+};
+
+// Register the sketch with alice2 (both old and new systems)
+ALICE2_REGISTER_SKETCH_AUTO(MCKernelBenchmarkSketch)
+
+#endif // __MAIN__
@@ -5,6 +5,7 @@
 #include <sketches/SketchRegistry.h>
 #include <computeGeom/scalarField.h>
 #include <computeGeom/ScalarField3D.h>
+#include <computeGeom/SdfExpression.h>
 #include <objects/MeshObject.h>
 #include <memory>
 #include <cmath>
@@ -28,7 +29,6 @@ public:
     // Endpoints
     ScalarField2D bottom_{kMinBB, kMaxBB};
     ScalarField2D top_   {kMinBB, kMaxBB};
-    ScalarField2D scratch_{kMinBB, kMaxBB};
 
     // Generated slices (inclusive of endpoints)
     vector<ScalarField2D> slices_;
@@ -167,36 +167,24 @@ public:
 
 private:
     // Build the two endpoints on the SAME grid (required for interpolate)
+    // Each endpoint is one SDF expression evaluated in a single pass
     void buildEndpoints() {
-        bottom_.clear_field();
-        bottom_.apply_scalar_rect(Vec3(0, 0, 0), kBottomRectHalfSize, 0); // rectangle
-        auto subtractCorner = [&](const Vec3& center) {
-            scratch_.clear_field();
-            scratch_.apply_scalar_circle(center, std::max(0.0f, cornerRadius_));
-            bottom_.boolean_subtract(scratch_);
-        };
         const float hx = kBottomRectHalfSize.x;
         const float hy = kBottomRectHalfSize.y;
-        subtractCorner(Vec3( hx,  hy, 0));
-        subtractCorner(Vec3(-hx,  hy, 0));
-        subtractCorner(Vec3( hx, -hy, 0));
-        subtractCorner(Vec3(-hx, -hy, 0));
-        top_.clear_field();
-        bool firstCircle = true;
-        auto addTopCorner = [&](const Vec3& center) {
-            scratch_.clear_field();
-            scratch_.apply_scalar_circle(center, kTopCircleRadius);
-            if (firstCircle) {
-                top_ = scratch_;
-                firstCircle = false;
-            } else {
-                top_.boolean_union(scratch_);
-            }
-        };
-        addTopCorner(Vec3( kTopCircleOffsetX,  kTopCircleOffsetY, 0));
-        addTopCorner(Vec3(-kTopCircleOffsetX,  kTopCircleOffsetY, 0));
-        addTopCorner(Vec3( kTopCircleOffsetX, -kTopCircleOffsetY, 0));
-        addTopCorner(Vec3(-kTopCircleOffsetX, -kTopCircleOffsetY, 0));
+        const float r = std::max(0.0f, cornerRadius_);
+        SdfExpression bottom = SdfExpression::rect(Vec3(0, 0, 0), kBottomRectHalfSize, 0); // rectangle
+        bottom = bottom.boolean_subtract(SdfExpression::circle(Vec3( hx,  hy, 0), r));
+        bottom = bottom.boolean_subtract(SdfExpression::circle(Vec3(-hx,  hy, 0), r));
+        bottom = bottom.boolean_subtract(SdfExpression::circle(Vec3( hx, -hy, 0), r));
+        bottom = bottom.boolean_subtract(SdfExpression::circle(Vec3(-hx, -hy, 0), r));
+        bottom_.apply_sdf(bottom);
+
+        SdfExpression top;
+        top = top.boolean_union(SdfExpression::circle(Vec3( kTopCircleOffsetX,  kTopCircleOffsetY, 0), kTopCircleRadius));
+        top = top.boolean_union(SdfExpression::circle(Vec3(-kTopCircleOffsetX,  kTopCircleOffsetY, 0), kTopCircleRadius));
+        top = top.boolean_union(SdfExpression::circle(Vec3( kTopCircleOffsetX, -kTopCircleOffsetY, 0), kTopCircleRadius));
+        top = top.boolean_union(SdfExpression::circle(Vec3(-kTopCircleOffsetX, -kTopCircleOffsetY, 0), kTopCircleRadius));
+        top_.apply_sdf(top);
     }
 
     // Linear interpolation: f_i = lerp(bottom, top, t_i), i=0..N-1
@@ -244,9 +232,8 @@ void Session_2_TowerSketch::rebuildVolumeMesh() {
         resY,
         resZ);
     volume.set_values(volumeValues);
-    isoMesh_ = volume.generate_mesh(iso_);
+    isoMesh_ = volume.generate_mesh_indexed(iso_);
     if (isoMesh_ && isoMeshObject_) {
-        isoMesh_->calculateNormals();
         isoMeshObject_->setMeshData(isoMesh_);
         isoMeshObject_->setRenderMode(MeshRenderMode::NormalShaded);
         isoMeshObject_->setNormalShadingColors(Color(0.1, 0.1, 0.1), Color(1, 1, 1));